@@ -408,6 +408,27 @@ Compactor::Internal::compact(Xapian::Compactor & compactor)
 	swap(used_ranges, used_ranges_);
     }
 
+#ifdef XAPIAN_HAS_BRASS_BACKEND
+    // Options recorded in the brass version file when a database is created
+    // affect what's stored in its tables, so all the sources must agree and
+    // the output gets the same options.
+    unsigned char brass_version_flags = 0;
+    if (backend == BRASS) {
+	for (size_t i = 0; i != sources.size(); ++i) {
+	    BrassVersion version_file(sources[i]);
+	    version_file.read_and_check();
+	    if (i == 0) {
+		brass_version_flags = version_file.get_flags();
+	    } else if (version_file.get_flags() != brass_version_flags) {
+		string msg = sources[i];
+		msg += ": database created with different options to ";
+		msg += sources[0];
+		throw Xapian::InvalidArgumentError(msg);
+	    }
+	}
+    }
+#endif
+
     string stub_file;
     if (compact_to_stub) {
 	stub_file = destdir;
@@ -481,7 +502,7 @@ Compactor::Internal::compact(Xapian::Compactor & compactor)
 #endif
     } else if (backend == BRASS) {
 #ifdef XAPIAN_HAS_BRASS_BACKEND
-	BrassVersion(destdir).create();
+	BrassVersion(destdir).create(brass_version_flags);
 #else
 	// Handled above.
 	exit(1);
@@ -59,6 +59,7 @@ LeafPostList::set_termweight(const Xapian::Weight * weight_)
     Assert(!weight);
     weight = weight_;
     need_doclength = weight->get_sumpart_needs_doclength_();
+    Xapian::Weight::Internal::init_inline_sumpart(*weight, sumpart);
 }
 
 double
@@ -75,6 +76,8 @@ LeafPostList::get_weight() const
     // Fetching the document length is work we can avoid if the weighting
     // scheme doesn't use it.
     if (need_doclength) doclen = get_doclength();
+    if (sumpart.type != InlineSumPart::NONE)
+	return sumpart.get_sumpart(get_wdf(), doclen);
     return weight->get_sumpart(get_wdf(), doclen);
 }
 
@@ -102,3 +105,9 @@ LeafPostList::count_matching_subqs() const
 {
     return weight ? 1 : 0;
 }
+
+LeafPostList *
+LeafPostList::open_nearby_postlist(const std::string &) const
+{
+    return NULL;
+}
@@ -47,6 +47,9 @@ class LeafPostList : public PostList {
 
     bool need_doclength;
 
+    /// Used to calculate the weight inline for built-in weighting schemes.
+    InlineSumPart sumpart;
+
     /// The term name for this postlist (empty for an alldocs postlist).
     std::string term;
 
@@ -87,6 +90,18 @@ class LeafPostList : public PostList {
 	const Xapian::Weight::Internal & stats) const;
 
     Xapian::termcount count_matching_subqs() const;
+
+    /** Open another postlist from the same database.
+     *
+     *  This may be able to reuse state from this postlist, which makes it
+     *  cheaper than Database::Internal::open_post_list() when @a term_ is
+     *  the same term as this postlist, or close to it in the term ordering.
+     *
+     *  @return	The new postlist, or NULL if this postlist can't help (in
+     *		which case the caller should open the postlist the usual
+     *		way).  The default implementation always returns NULL.
+     */
+    virtual LeafPostList * open_nearby_postlist(const std::string & term_) const;
 };
 
 #endif // XAPIAN_INCLUDED_LEAFPOSTLIST_H
@@ -41,6 +41,7 @@
 #include "matcher/multimatch.h"
 #include "omassert.h"
 #include "api/omenquireinternal.h"
+#include "realtime.h"
 #include "str.h"
 #include "weight/weightinternal.h"
 
@@ -309,6 +310,27 @@ MSet::get_max_attained() const
     return internal->max_attained;
 }
 
+double
+MSet::get_setup_time() const
+{
+    Assert(internal.get() != 0);
+    return internal->setup_time;
+}
+
+double
+MSet::get_match_time() const
+{
+    Assert(internal.get() != 0);
+    return internal->match_time;
+}
+
+Xapian::doccount
+MSet::get_candidates_considered() const
+{
+    Assert(internal.get() != 0);
+    return internal->candidates_considered;
+}
+
 Xapian::doccount
 MSet::size() const
 {
@@ -683,6 +705,9 @@ Enquire::Internal::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 	check_at_least = max(check_at_least, maxitems);
     }
 
+    // Constructing the MultiMatch gathers the statistics, which counts as
+    // part of the setup time for the query.
+    double start_time = RealTime::now();
     Xapian::Weight::Internal stats;
     ::MultiMatch match(db, query, qlen, rset,
 		       collapse_max, collapse_key,
@@ -691,6 +716,10 @@ Enquire::Internal::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 		       errorhandler, stats, weight, spies,
 		       (sorter != NULL),
 		       (mdecider != NULL));
+    double stats_time = RealTime::now() - start_time;
+    // Record the terms OP_WILDCARD subqueries expand to, so they count as
+    // query terms for get_matching_terms() and get_eset().
+    stats.record_wildcard_terms();
     // Run query and put results into supplied Xapian::MSet object.
     MSet retval;
     match.get_mset(first, maxitems, check_at_least, retval,
@@ -698,6 +727,7 @@ Enquire::Internal::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
     if (first_orig != first && retval.internal.get()) {
 	retval.internal->firstitem = first_orig;
     }
+    retval.internal->setup_time += stats_time;
 
     Assert(weight->name() != "bool" || retval.get_max_possible() == 0);
 
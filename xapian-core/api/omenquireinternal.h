@@ -32,6 +32,8 @@
 #include "xapian/query.h"
 #include "xapian/keymaker.h"
 
+#include "internaltypes.h"
+
 #include <algorithm>
 #include <cmath>
 #include <map>
@@ -56,15 +58,16 @@ namespace Internal {
 class MSetItem {
     public:
 	MSetItem(double wt_, Xapian::docid did_)
-		: wt(wt_), did(did_), collapse_count(0) {}
+		: wt(wt_), did(did_), collapse_count(0), sort_key_prefix(0) {}
 
 	MSetItem(double wt_, Xapian::docid did_, const string &key_)
-		: wt(wt_), did(did_), collapse_key(key_), collapse_count(0) {}
+		: wt(wt_), did(did_), collapse_key(key_), collapse_count(0),
+		  sort_key_prefix(0) {}
 
 	MSetItem(double wt_, Xapian::docid did_, const string &key_,
 		 Xapian::doccount collapse_count_)
 		: wt(wt_), did(did_), collapse_key(key_),
-		  collapse_count(collapse_count_) {}
+		  collapse_count(collapse_count_), sort_key_prefix(0) {}
 
 	void swap(MSetItem & o) {
 	    std::swap(wt, o.wt);
@@ -72,6 +75,33 @@ class MSetItem {
 	    std::swap(collapse_key, o.collapse_key);
 	    std::swap(collapse_count, o.collapse_count);
 	    std::swap(sort_key, o.sort_key);
+	    std::swap(sort_key_prefix, o.sort_key_prefix);
+	}
+
+	/** Set sort_key, and update sort_key_prefix to match.
+	 *
+	 *  sort_key should always be set using this method so that the two
+	 *  are kept in step.
+	 */
+	void set_sort_key(const string & key) {
+	    sort_key = key;
+	    sort_key_prefix = 0;
+	    for (size_t i = 0; i != 8; ++i) {
+		sort_key_prefix <<= 8;
+		if (i < key.size())
+		    sort_key_prefix |= static_cast<unsigned char>(key[i]);
+	    }
+	}
+
+	/** Compare the sort keys of this item and @a o.
+	 *
+	 *  @return < 0, 0 or > 0 if this item's sort_key is respectively
+	 *	    less than, equal to, or greater than that of @a o.
+	 */
+	int compare_sort_key(const MSetItem & o) const {
+	    if (sort_key_prefix != o.sort_key_prefix)
+		return sort_key_prefix < o.sort_key_prefix ? -1 : 1;
+	    return sort_key.compare(o.sort_key);
 	}
 
 	/** Weight calculated. */
@@ -104,6 +134,15 @@ class MSetItem {
 	/** Used when sorting by value. */
 	string sort_key;
 
+	/** The first 8 bytes of sort_key packed big-endian into an integer.
+	 *
+	 *  If sort_key is shorter than 8 bytes, it is padded with zero bytes.
+	 *  Comparing these first means that most pairs of items can be
+	 *  ordered by value with a single integer comparison - we only need
+	 *  to compare the sort_key strings if the prefixes are equal.
+	 */
+	uint8 sort_key_prefix;
+
 	/// Return a string describing this object.
 	string get_description() const;
 };
@@ -259,6 +298,15 @@ class MSet::Internal : public Xapian::Internal::intrusive_base {
 
 	double max_attained;
 
+	/// Seconds spent gathering statistics and building the postlist tree.
+	double setup_time;
+
+	/// Seconds spent running the match.
+	double match_time;
+
+	/// Number of candidate documents the matcher looked at.
+	Xapian::doccount candidates_considered;
+
 	Internal()
 		: percent_factor(0),
 		  firstitem(0),
@@ -269,7 +317,10 @@ class MSet::Internal : public Xapian::Internal::intrusive_base {
 		  uncollapsed_estimated(0),
 		  uncollapsed_upper_bound(0),
 		  max_possible(0),
-		  max_attained(0) {}
+		  max_attained(0),
+		  setup_time(0),
+		  match_time(0),
+		  candidates_considered(0) {}
 
 	/// Note: destroys parameter items.
 	Internal(Xapian::doccount firstitem_,
@@ -294,7 +345,10 @@ class MSet::Internal : public Xapian::Internal::intrusive_base {
 		  uncollapsed_estimated(uncollapsed_estimated_),
 		  uncollapsed_upper_bound(uncollapsed_upper_bound_),
 		  max_possible(max_possible_),
-		  max_attained(max_attained_) {
+		  max_attained(max_attained_),
+		  setup_time(0),
+		  match_time(0),
+		  candidates_considered(0) {
 	    std::swap(items, items_);
 	}
 
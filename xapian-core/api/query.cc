@@ -62,8 +62,11 @@ Query::Query(op op_, const Xapian::Query & subquery, double factor)
 Query::Query(op op_, Xapian::valueno slot, const std::string & limit)
 {
     if (op_ == OP_VALUE_GE) {
+	// Build a new object rather than sharing MatchAll.internal, so that
+	// Query objects built in different threads don't share a reference
+	// count.
 	if (limit.empty())
-	    internal = MatchAll.internal;
+	    internal = new Xapian::Internal::QueryTerm(string(), 1, 0);
 	else
 	    internal = new Xapian::Internal::QueryValueGE(slot, limit);
     } else if (usual(op_ == OP_VALUE_LE)) {
@@ -86,6 +89,18 @@ Query::Query(op op_, Xapian::valueno slot,
     }
 }
 
+Query::Query(op op_, const std::string & pattern,
+	     Xapian::termcount max_expansion, int max_type)
+{
+    if (rare(op_ != OP_WILDCARD))
+	throw Xapian::InvalidArgumentError("op must be OP_WILDCARD");
+    if (rare(max_type < WILDCARD_LIMIT_ERROR ||
+	     max_type > WILDCARD_LIMIT_MOST_FREQUENT))
+	throw Xapian::InvalidArgumentError("Unknown wildcard limit type");
+    internal = new Xapian::Internal::QueryWildcard(pattern, max_expansion,
+						   max_type);
+}
+
 const TermIterator
 Query::get_terms_begin() const
 {
@@ -23,17 +23,20 @@
 
 #include "queryinternal.h"
 
+#include "xapian/error.h"
 #include "xapian/postingsource.h"
 #include "xapian/query.h"
 
 #include "matcher/const_database_wrapper.h"
 #include "leafpostlist.h"
+#include "termlist.h"
 #include "matcher/andmaybepostlist.h"
 #include "matcher/andnotpostlist.h"
 #include "emptypostlist.h"
 #include "matcher/exactphrasepostlist.h"
 #include "matcher/externalpostlist.h"
 #include "matcher/multiandpostlist.h"
+#include "matcher/multiorpostlist.h"
 #include "matcher/multixorpostlist.h"
 #include "matcher/orpostlist.h"
 #include "matcher/phrasepostlist.h"
@@ -116,11 +119,19 @@ struct CmpMaxOrTerms {
     }
 };
 
-/// Comparison functor which orders PostList* by descending get_termfreq_est().
-struct ComparePostListTermFreqAscending {
-    /// Order by descending get_termfreq_est().
-    bool operator()(const PostList *a, const PostList *b) {
-	return a->get_termfreq_est() > b->get_termfreq_est();
+/** Comparison functor which orders (term, termfreq) pairs by descending
+ *  termfreq.
+ *
+ *  Ties are broken by ascending term, so the terms chosen for
+ *  WILDCARD_LIMIT_MOST_FREQUENT don't depend on the order they're seen in.
+ */
+struct CmpTermFreqDescending {
+    /// Order by descending termfreq, then ascending term.
+    bool operator()(const pair<string, Xapian::doccount> & a,
+		    const pair<string, Xapian::doccount> & b) const {
+	if (a.second != b.second)
+	    return a.second > b.second;
+	return a.first < b.first;
     }
 };
 
@@ -136,6 +147,10 @@ class Context {
     void add_postlist(PostList * pl) {
 	pls.push_back(pl);
     }
+
+    bool empty() const { return pls.empty(); }
+
+    size_t size() const { return pls.size(); }
 };
 
 Context::Context(size_t reserve) {
@@ -152,13 +167,15 @@ class OrContext : public Context {
     explicit OrContext(size_t reserve) : Context(reserve) { }
 
     /// Select the best set_size postlists from the last out_of added.
-    void select_elite_set(size_t set_size, size_t out_of);
+    void select_elite_set(QueryOptimiser* qopt,
+			  size_t set_size, size_t out_of);
 
     PostList * postlist(QueryOptimiser* qopt);
 };
 
 void
-OrContext::select_elite_set(size_t set_size, size_t out_of)
+OrContext::select_elite_set(QueryOptimiser* qopt,
+			    size_t set_size, size_t out_of)
 {
     // Call recalc_maxweight() as otherwise get_maxweight()
     // may not be valid before next() or skip_to()
@@ -166,14 +183,19 @@ OrContext::select_elite_set(size_t set_size, size_t out_of)
     for_each(begin, pls.end(), mem_fun(&PostList::recalc_maxweight));
 
     nth_element(begin, begin + set_size - 1, pls.end(), CmpMaxOrTerms());
-    for_each(begin + set_size, pls.end(), delete_ptr<PostList>());
+    vector<PostList*>::iterator i;
+    for (i = begin + set_size; i != pls.end(); ++i) {
+	qopt->destroy_postlist(*i);
+    }
     pls.resize(pls.size() - out_of + set_size);
 }
 
 PostList *
 OrContext::postlist(QueryOptimiser* qopt)
 {
-    Assert(!pls.empty());
+    // An OP_WILDCARD subquery can expand to no terms.
+    if (pls.empty())
+	return new EmptyPostList;
 
     if (pls.size() == 1) {
 	PostList * pl = pls[0];
@@ -181,39 +203,29 @@ OrContext::postlist(QueryOptimiser* qopt)
 	return pl;
     }
 
-    // Make postlists into a heap so that the postlist with the greatest term
-    // frequency is at the top of the heap.
-    make_heap(pls.begin(), pls.end(), ComparePostListTermFreqAscending());
+    if (pls.size() > 2) {
+	// Use a single N-way OR rather than a tree of binary OrPostList
+	// objects, which avoids a virtual method call per level of the tree
+	// for each posting.
+	PostList * pl = new MultiOrPostList(pls.begin(), pls.end(),
+					    qopt->matcher, qopt->db_size);
+	pls.clear();
+	return pl;
+    }
 
-    // Now build a tree of binary OrPostList objects.
+    // We build the OrPostList such that:
     //
-    // The algorithm used to build the tree is like that used to build an
-    // optimal Huffman coding tree.  If we called next() repeatedly, this
-    // arrangement would minimise the number of method calls.  Generally we
-    // don't actually do that, but this arrangement is still likely to be a
-    // good one, and it does minimise the work in the worst case.
-    while (true) {
-	// We build the tree such that at each branch:
-	//
-	//   l.get_termfreq_est() >= r.get_termfreq_est()
-	//
-	// We do this so that the OrPostList class can be optimised assuming
-	// that this is the case.
-	PostList * r = pls.front();
-	pop_heap(pls.begin(), pls.end(), ComparePostListTermFreqAscending());
-	pls.pop_back();
-	PostList * pl;
-	pl = new OrPostList(pls.front(), r, qopt->matcher, qopt->db_size);
-
-	if (pls.size() == 1) {
-	    pls.clear();
-	    return pl;
-	}
-
-	pop_heap(pls.begin(), pls.end(), ComparePostListTermFreqAscending());
-	pls.back() = pl;
-	push_heap(pls.begin(), pls.end(), ComparePostListTermFreqAscending());
-    }
+    //   l.get_termfreq_est() >= r.get_termfreq_est()
+    //
+    // We do this so that the OrPostList class can be optimised assuming
+    // that this is the case.
+    PostList * l = pls[0];
+    PostList * r = pls[1];
+    if (l->get_termfreq_est() < r->get_termfreq_est())
+	swap(l, r);
+    PostList * pl = new OrPostList(l, r, qopt->matcher, qopt->db_size);
+    pls.clear();
+    return pl;
 }
 
 class XorContext : public Context {
@@ -326,6 +338,11 @@ Query::Internal::gather_terms(void *) const
 {
 }
 
+void
+Query::Internal::gather_wildcards(void *) const
+{
+}
+
 Xapian::termcount
 Query::Internal::get_length() const
 {
@@ -437,6 +454,18 @@ Query::Internal::unserialise(const char ** p, const char * end,
 	}
 	case 0: {
 	    switch (ch & 0x0f) {
+		case 0x0b: { // Wildcard
+		    Xapian::termcount max_expansion;
+		    max_expansion = decode_length(p, end, false);
+		    if (*p == end)
+			throw SerialisationError("Not enough data");
+		    int max_type = static_cast<unsigned char>(*(*p)++);
+		    size_t len = decode_length(p, end, true);
+		    string pattern(*p, len);
+		    *p += len;
+		    using Xapian::Internal::QueryWildcard;
+		    return new QueryWildcard(pattern, max_expansion, max_type);
+		}
 		case 0x0c: { // PostingSource
 		    size_t len = decode_length(p, end, true);
 		    string name(*p, len);
@@ -469,7 +498,9 @@ Query::Internal::unserialise(const char ** p, const char * end,
 		    return new Xapian::Internal::QueryTerm(string(), wqf, pos);
 		}
 		case 0x0f:
-		    return Query::MatchAll.internal.get();
+		    // Query::MatchAll, but don't share its internals as they
+		    // may be in use in another thread.
+		    return new Xapian::Internal::QueryTerm(string(), 1, 0);
 		default: // Others currently unused.
 		    break;
 	    }
@@ -551,6 +582,18 @@ QueryPostingSource::get_description() const
     return desc;
 }
 
+string
+QueryWildcard::get_description() const
+{
+    string desc = "WILDCARD ";
+    desc += pattern;
+    if (max_expansion) {
+	desc += ' ';
+	desc += str(max_expansion);
+    }
+    return desc;
+}
+
 QueryScaleWeight::QueryScaleWeight(double factor, const Query & subquery_)
     : scale_factor(factor), subquery(subquery_)
 {
@@ -607,6 +650,140 @@ QueryScaleWeight::postlist(QueryOptimiser * qopt, double factor) const
     RETURN(subquery.internal->postlist(qopt, factor * scale_factor));
 }
 
+void
+QueryWildcard::expand_terms(const Xapian::Database::Internal & db,
+			    vector<pair<string, Xapian::doccount> > & terms) const
+{
+    // A pattern containing '*' can match in the middle or at the end of
+    // terms, which the backend may be able to look up without scanning all
+    // the terms.
+    terms.clear();
+    bool is_prefix = (pattern.find('*') == string::npos);
+    AutoPtr<TermList> t(is_prefix ?
+			db.open_allterms(pattern) :
+			db.open_wildcard_terms(pattern));
+    bool most_frequent = (max_expansion &&
+			  max_type == Query::WILDCARD_LIMIT_MOST_FREQUENT);
+    CmpTermFreqDescending cmp;
+    while (true) {
+	TermList * res = t->next();
+	if (res) t.reset(res);
+	if (t->at_end())
+	    break;
+	if (max_expansion && terms.size() == max_expansion) {
+	    if (max_type == Query::WILDCARD_LIMIT_FIRST)
+		break;
+	    if (max_type == Query::WILDCARD_LIMIT_ERROR) {
+		string msg("Wildcard ");
+		msg += pattern;
+		if (is_prefix) msg += '*';
+		msg += " expands to more than ";
+		msg += str(max_expansion);
+		msg += " terms";
+		throw Xapian::WildcardError(msg);
+	    }
+	    // terms is a heap with the least frequent term at the front.  A
+	    // term with the same frequency loses as it sorts later.
+	    Xapian::doccount tf = t->get_termfreq();
+	    if (tf <= terms.front().second)
+		continue;
+	    pop_heap(terms.begin(), terms.end(), cmp);
+	    terms.back().first = t->get_termname();
+	    terms.back().second = tf;
+	    push_heap(terms.begin(), terms.end(), cmp);
+	    continue;
+	}
+	terms.push_back(make_pair(t->get_termname(), t->get_termfreq()));
+	if (most_frequent && terms.size() == max_expansion)
+	    make_heap(terms.begin(), terms.end(), cmp);
+    }
+
+    // Return the terms in sort order, which is the order the postlists are
+    // best opened in.
+    if (most_frequent)
+	sort(terms.begin(), terms.end());
+}
+
+void
+QueryWildcard::expand(OrContext& ctx, QueryOptimiser * qopt) const
+{
+    // We open a postlist for each term, rather than building a Query object
+    // for each, and the OR of them is a single MultiOrPostList.  Gathering
+    // the stats normally expands the wildcard in each sub-database already.
+    const vector<string> * expansion = qopt->get_wildcard_expansion(this);
+    vector<string> terms;
+    if (!expansion) {
+	// The stats came from elsewhere (e.g. a remote client), so expand it
+	// here, which picks the same terms.
+	vector<pair<string, Xapian::doccount> > freqs;
+	expand_terms(qopt->db, freqs);
+	terms.reserve(freqs.size());
+	vector<pair<string, Xapian::doccount> >::const_iterator i;
+	for (i = freqs.begin(); i != freqs.end(); ++i)
+	    terms.push_back(i->first);
+	expansion = &terms;
+    }
+
+    vector<string>::const_iterator i;
+    for (i = expansion->begin(); i != expansion->end(); ++i)
+	ctx.add_postlist(qopt->open_post_list(*i, 0.0));
+}
+
+PostingIterator::Internal *
+QueryWildcard::postlist(QueryOptimiser * qopt, double factor) const
+{
+    LOGCALL(QUERY, PostingIterator::Internal *, "QueryWildcard::postlist", qopt | factor);
+    // Like OP_SYNONYM, the whole expansion counts as one subquery (or none
+    // if we're not weighted).
+    Xapian::termcount save_total_subqs = qopt->get_total_subqs();
+    if (factor != 0.0)
+	++save_total_subqs;
+    qopt->set_total_subqs(save_total_subqs);
+
+    OrContext ctx(0);
+    expand(ctx, qopt);
+    if (ctx.empty())
+	RETURN(new EmptyPostList);
+
+    PostList * pl = ctx.postlist(qopt);
+    if (factor != 0.0)
+	pl = qopt->make_synonym_postlist(pl, factor);
+    RETURN(pl);
+}
+
+void
+QueryWildcard::postlist_sub_or_like(OrContext& ctx, QueryOptimiser * qopt,
+				    double factor) const
+{
+    if (factor != 0.0) {
+	// The expansion needs to be weighted as a single synonym.
+	ctx.add_postlist(postlist(qopt, factor));
+	return;
+    }
+    // Unweighted, so we can add the expanded terms straight into the
+    // enclosing OR.
+    expand(ctx, qopt);
+}
+
+void
+QueryWildcard::gather_terms(void * void_terms) const
+{
+    // We don't know the position of the wildcard in the query.
+    vector<pair<Xapian::termpos, string> > &terms =
+	*static_cast<vector<pair<Xapian::termpos, string> >*>(void_terms);
+    vector<string>::const_iterator i;
+    for (i = expanded_terms.begin(); i != expanded_terms.end(); ++i)
+	terms.push_back(make_pair(Xapian::termpos(0), *i));
+}
+
+void
+QueryWildcard::gather_wildcards(void * void_wildcards) const
+{
+    vector<const QueryWildcard *> &wildcards =
+	*static_cast<vector<const QueryWildcard *>*>(void_wildcards);
+    wildcards.push_back(this);
+}
+
 void
 QueryTerm::gather_terms(void * void_terms) const
 {
@@ -837,6 +1014,17 @@ QueryBranch::gather_terms(void * void_terms) const
     }
 }
 
+void
+QueryBranch::gather_wildcards(void * void_wildcards) const
+{
+    QueryVector::const_iterator i;
+    for (i = subqueries.begin(); i != subqueries.end(); ++i) {
+	// MatchNothing subqueries should have been removed by done().
+	Assert((*i).internal.get());
+	(*i).internal->gather_wildcards(void_wildcards);
+    }
+}
+
 void
 QueryBranch::do_or_like(OrContext& ctx, QueryOptimiser * qopt, double factor,
 			Xapian::termcount elite_set_size, size_t first) const
@@ -851,6 +1039,9 @@ QueryBranch::do_or_like(OrContext& ctx, QueryOptimiser * qopt, double factor,
     vector<PostList *> postlists;
     postlists.reserve(subqueries.size() - first);
 
+    // An unweighted OP_WILDCARD adds a postlist for each term it expands to,
+    // so count how many postlists we add.
+    size_t start = ctx.size();
     QueryVector::const_iterator q;
     for (q = subqueries.begin() + first; q != subqueries.end(); ++q) {
 	// MatchNothing subqueries should have been removed by done().
@@ -858,8 +1049,9 @@ QueryBranch::do_or_like(OrContext& ctx, QueryOptimiser * qopt, double factor,
 	(*q).internal->postlist_sub_or_like(ctx, qopt, factor);
     }
 
-    if (elite_set_size && elite_set_size < subqueries.size()) {
-	ctx.select_elite_set(elite_set_size, subqueries.size());
+    size_t out_of = ctx.size() - start;
+    if (elite_set_size && elite_set_size < out_of) {
+	ctx.select_elite_set(qopt, elite_set_size, out_of);
 	// FIXME: not right!
     }
 }
@@ -926,6 +1118,12 @@ QueryScaleWeight::gather_terms(void * void_terms) const
     subquery.internal->gather_terms(void_terms);
 }
 
+void
+QueryScaleWeight::gather_wildcards(void * void_wildcards) const
+{
+    subquery.internal->gather_wildcards(void_wildcards);
+}
+
 void QueryTerm::serialise(string & result) const
 {
     size_t len = term.size();
@@ -998,6 +1196,15 @@ void QueryPostingSource::serialise(string & result) const
     result += s;
 }
 
+void QueryWildcard::serialise(string & result) const
+{
+    result += static_cast<char>(0x0b);
+    result += encode_length(max_expansion);
+    result += static_cast<char>(max_type);
+    result += encode_length(pattern.size());
+    result += pattern;
+}
+
 void QueryScaleWeight::serialise(string & result) const
 {
     Assert(subquery.internal.get());
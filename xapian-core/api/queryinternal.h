@@ -23,9 +23,14 @@
 
 #include "postlist.h"
 #include "queryvector.h"
+#include "xapian/database.h"
 #include "xapian/intrusive_ptr.h"
 #include "xapian/query.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 /// Default set_size for OP_ELITE_SET:
 const Xapian::termcount DEFAULT_ELITE_SET_SIZE = 10;
 
@@ -92,6 +97,8 @@ class QueryScaleWeight : public Query::Internal {
     std::string get_description() const;
 
     void gather_terms(void * void_terms) const;
+
+    void gather_wildcards(void * void_wildcards) const;
 };
 
 class QueryValueRange : public Query::Internal {
@@ -144,6 +151,63 @@ class QueryValueGE : public Query::Internal {
     std::string get_description() const;
 };
 
+class QueryWildcard : public Query::Internal {
+    std::string pattern;
+
+    Xapian::termcount max_expansion;
+
+    int max_type;
+
+    /** The terms this wildcard expanded to when last used in a match.
+     *
+     *  These are reported by gather_terms() so that they count as query
+     *  terms for Enquire::get_matching_terms() and the like.
+     */
+    mutable std::vector<std::string> expanded_terms;
+
+    /// Add a postlist to @a ctx for each term the wildcard expands to.
+    void expand(OrContext& ctx, QueryOptimiser * qopt) const;
+
+  public:
+    QueryWildcard(const std::string & pattern_,
+		  Xapian::termcount max_expansion_,
+		  int max_type_)
+	: pattern(pattern_), max_expansion(max_expansion_),
+	  max_type(max_type_) { }
+
+    const std::string & get_pattern() const { return pattern; }
+
+    /** Find the terms this wildcard expands to in @a db.
+     *
+     *  The expansion limit is applied, and WildcardError is thrown if it's
+     *  exceeded and the limit type is WILDCARD_LIMIT_ERROR.
+     *
+     *  @param db	The sub-database to expand the wildcard in.
+     *  @param terms	Set to the terms (in sort order) with their termfreqs.
+     */
+    void expand_terms(const Xapian::Database::Internal & db,
+		      std::vector<std::pair<std::string, Xapian::doccount> > & terms) const;
+
+    /// Record the terms this wildcard expanded to (swaps with @a terms).
+    void set_expanded_terms(std::vector<std::string> & terms) const {
+	expanded_terms.swap(terms);
+    }
+
+    PostingIterator::Internal * postlist(QueryOptimiser * qopt, double factor) const;
+
+    void postlist_sub_or_like(OrContext& ctx, QueryOptimiser * qopt, double factor) const;
+
+    termcount get_length() const { return 1; }
+
+    void serialise(std::string & result) const;
+
+    std::string get_description() const;
+
+    void gather_terms(void * void_terms) const;
+
+    void gather_wildcards(void * void_wildcards) const;
+};
+
 class QueryBranch : public Query::Internal {
     virtual Xapian::Query::op get_op() const = 0;
 
@@ -169,6 +233,8 @@ class QueryBranch : public Query::Internal {
 
     void gather_terms(void * void_terms) const;
 
+    void gather_wildcards(void * void_wildcards) const;
+
     virtual void add_subquery(const Xapian::Query & subquery) = 0;
 
     size_t num_subqueries() const { return subqueries.size(); }
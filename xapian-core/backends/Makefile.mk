@@ -11,7 +11,8 @@ noinst_HEADERS +=\
 	backends/prefix_compressed_strings.h\
 	backends/slowvaluelist.h\
 	backends/valuelist.h\
-	backends/valuestats.h
+	backends/valuestats.h\
+	backends/wildcardtermlist.h
 
 EXTRA_DIST +=\
 	backends/dir_contents\
@@ -24,7 +25,8 @@ lib_src +=\
 	backends/databasereplicator.cc\
 	backends/dbfactory.cc\
 	backends/slowvaluelist.cc\
-	backends/valuelist.cc
+	backends/valuelist.cc\
+	backends/wildcardtermlist.cc
 
 if BUILD_BACKEND_REMOTE
 lib_src +=\
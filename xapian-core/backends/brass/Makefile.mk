@@ -18,6 +18,7 @@ noinst_HEADERS +=\
 	backends/brass/brass_inverter.h\
 	backends/brass/brass_lazytable.h\
 	backends/brass/brass_metadata.h\
+	backends/brass/brass_permuterm.h\
 	backends/brass/brass_positionlist.h\
 	backends/brass/brass_postlist.h\
 	backends/brass/brass_record.h\
@@ -47,6 +48,7 @@ lib_src +=\
 	backends/brass/brass_document.cc\
 	backends/brass/brass_inverter.cc\
 	backends/brass/brass_metadata.cc\
+	backends/brass/brass_permuterm.cc\
 	backends/brass/brass_positionlist.cc\
 	backends/brass/brass_postlist.cc\
 	backends/brass/brass_record.cc\
@@ -421,6 +421,32 @@ BrassTable_base::next_free_block()
     return n;
 }
 
+/* next_free_block_after(B, n) is like next_free_block(B), except that it
+   first checks whether block n + 1 is available (free both now and at the
+   start of the transaction) and if so allocates that.  This allows runs of
+   contiguous blocks to be allocated for data which is being written in
+   order, even if there are free blocks earlier in the file.
+*/
+
+uint4
+BrassTable_base::next_free_block_after(uint4 n)
+{
+    ++n;
+    uint4 i = n / CHAR_BIT;
+    while (i >= bit_map_size) {
+	extend_bit_map();
+    }
+    int bit = 0x1 << n % CHAR_BIT;
+    if (((bit_map0[i] | bit_map[i]) & bit) != 0) {
+	return next_free_block();
+    }
+    bit_map[i] |= bit;   /* set as 'in use' */
+    if (n > last_block) {
+	last_block = n;
+    }
+    return n;
+}
+
 bool
 BrassTable_base::find_changed_block(uint4 * n)
 {
@@ -98,6 +98,13 @@ class BrassTable_base {
 
 	uint4 next_free_block();
 
+	/** Allocate block n + 1 if it is available, else the next free block.
+	 *
+	 *  Used when adding items sequentially, so that consecutive leaf
+	 *  blocks end up next to each other in the file where possible.
+	 */
+	uint4 next_free_block_after(uint4 n);
+
 	/** Find the first changed block at or after position *n.
 	 *
 	 *  Returns true if such a block was found, or false otherwise.
@@ -84,7 +84,7 @@ class PostlistCursor : private BrassCursor {
   public:
     string key, tag;
     Xapian::docid firstdid;
-    Xapian::termcount tf, cf;
+    Xapian::termcount tf, cf, wdf_max;
 
     PostlistCursor(BrassTable *in, Xapian::docid offset_)
 	: BrassCursor(in), offset(offset_), firstdid(0)
@@ -105,7 +105,7 @@ class PostlistCursor : private BrassCursor {
 	read_tag();
 	key = current_key;
 	tag = current_tag;
-	tf = cf = 0;
+	tf = cf = wdf_max = 0;
 	if (is_metainfo_key(key)) return true;
 	if (is_user_metadata_key(key)) return true;
 	if (is_valuestats_key(key)) return true;
@@ -146,6 +146,7 @@ class PostlistCursor : private BrassCursor {
 	    e = d + tag.size();
 	    if (!unpack_uint(&d, e, &tf) ||
 		!unpack_uint(&d, e, &cf) ||
+		!unpack_uint(&d, e, &wdf_max) ||
 		!unpack_uint(&d, e, &firstdid)) {
 		throw Xapian::DatabaseCorruptError("Bad postlist key");
 	    }
@@ -401,7 +402,8 @@ merge_postlists(Xapian::Compactor & compactor,
 	}
     }
 
-    Xapian::termcount tf = 0, cf = 0; // Initialise to avoid warnings.
+    // Initialise to avoid warnings.
+    Xapian::termcount tf = 0, cf = 0, wdf_max = 0;
     vector<pair<Xapian::docid, string> > tags;
     while (true) {
 	PostlistCursor * cur = NULL;
@@ -415,6 +417,7 @@ merge_postlists(Xapian::Compactor & compactor,
 		string first_tag;
 		pack_uint(first_tag, tf);
 		pack_uint(first_tag, cf);
+		pack_uint(first_tag, wdf_max);
 		pack_uint(first_tag, tags[0].first - 1);
 		string tag = tags[0].second;
 		tag[0] = (tags.size() == 1) ? '1' : '0';
@@ -439,11 +442,12 @@ merge_postlists(Xapian::Compactor & compactor,
 	    }
 	    tags.clear();
 	    if (cur == NULL) break;
-	    tf = cf = 0;
+	    tf = cf = wdf_max = 0;
 	    last_key = cur->key;
 	}
 	tf += cur->tf;
 	cf += cur->cf;
+	wdf_max = max(wdf_max, cur->wdf_max);
 	tags.push_back(make_pair(cur->firstdid, cur->tag));
 	if (cur->next()) {
 	    pq.push(cur);
@@ -728,6 +732,46 @@ multimerge_postlists(Xapian::Compactor & compactor,
     }
 }
 
+static void
+merge_permuterms(BrassTable * out,
+		 vector<string>::const_iterator b,
+		 vector<string>::const_iterator e)
+{
+    priority_queue<MergeCursor *, vector<MergeCursor *>, CursorGt> pq;
+    for ( ; b != e; ++b) {
+	BrassTable *in = new BrassTable("permuterm", *b, true, DONT_COMPRESS, true);
+	in->open();
+	if (!in->empty()) {
+	    // The MergeCursor takes ownership of BrassTable in and is
+	    // responsible for deleting it.
+	    pq.push(new MergeCursor(in));
+	} else {
+	    delete in;
+	}
+    }
+
+    // The entry for a rotation of a term is the same in every database the
+    // term is in, so we just want the union of the keys.
+    string last_key;
+    bool first = true;
+    while (!pq.empty()) {
+	MergeCursor * cur = pq.top();
+	pq.pop();
+
+	if (first || cur->current_key != last_key) {
+	    first = false;
+	    last_key = cur->current_key;
+	    bool compressed = cur->read_tag(true);
+	    out->add(last_key, cur->current_tag, compressed);
+	}
+	if (cur->next()) {
+	    pq.push(cur);
+	} else {
+	    delete cur;
+	}
+    }
+}
+
 static void
 merge_docid_keyed(const char * tablename,
 		  BrassTable *out, const vector<string> & inputs,
@@ -782,7 +826,8 @@ compact_brass(Xapian::Compactor & compactor,
 	      Xapian::Compactor::compaction_level compaction, bool multipass,
 	      Xapian::docid last_docid) {
     enum table_type {
-	POSTLIST, RECORD, TERMLIST, POSITION, VALUE, SPELLING, SYNONYM
+	POSTLIST, RECORD, TERMLIST, POSITION, VALUE, SPELLING, SYNONYM,
+	PERMUTERM
     };
     struct table_list {
 	// The "base name" of the table.
@@ -802,7 +847,8 @@ compact_brass(Xapian::Compactor & compactor,
 	{ "termlist",	TERMLIST,	Z_DEFAULT_STRATEGY,	false },
 	{ "position",	POSITION,	DONT_COMPRESS,		true },
 	{ "spelling",	SPELLING,	Z_DEFAULT_STRATEGY,	true },
-	{ "synonym",	SYNONYM,	Z_DEFAULT_STRATEGY,	true }
+	{ "synonym",	SYNONYM,	Z_DEFAULT_STRATEGY,	true },
+	{ "permuterm",	PERMUTERM,	DONT_COMPRESS,		true }
     };
     const table_list * tables_end = tables +
 	(sizeof(tables) / sizeof(tables[0]));
@@ -851,8 +897,10 @@ compact_brass(Xapian::Compactor & compactor,
 	    inputs.push_back(s);
 	}
 
-	// If any inputs lack a termlist table, suppress it in the output.
-	if (t->type == TERMLIST && inputs_present != sources.size()) {
+	// If any inputs lack a termlist or permuterm table, suppress it in the
+	// output as it would be incomplete.
+	if ((t->type == TERMLIST || t->type == PERMUTERM) &&
+	    inputs_present != sources.size()) {
 	    if (inputs_present != 0) {
 		string m = str(inputs_present);
 		m += " of ";
@@ -897,6 +945,9 @@ compact_brass(Xapian::Compactor & compactor,
 	    case SYNONYM:
 		merge_synonyms(&out, inputs.begin(), inputs.end());
 		break;
+	    case PERMUTERM:
+		merge_permuterms(&out, inputs.begin(), inputs.end());
+		break;
 	    default:
 		// Position, Record, Termlist
 		merge_docid_keyed(t->name, &out, inputs, offset, t->lazy);
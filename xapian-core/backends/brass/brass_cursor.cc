@@ -31,6 +31,8 @@
 #include "debuglog.h"
 #include "omassert.h"
 
+#include <cstring>
+
 using namespace Brass;
 
 #ifdef XAPIAN_DEBUG_LOG
@@ -111,6 +113,23 @@ BrassCursor::~BrassCursor()
     delete [] C;
 }
 
+BrassCursor *
+BrassCursor::clone() const
+{
+    LOGCALL(DB, BrassCursor *, "BrassCursor::clone", NO_ARGS);
+    BrassCursor * new_cursor = new BrassCursor(B);
+    // If the table has been modified since our blocks were read, they may
+    // be out of date, so just return a fresh cursor.
+    if (version == B->cursor_version && level == new_cursor->level) {
+	for (int j = 0; j < level; ++j) {
+	    if (C[j].n == BLK_UNUSED) continue;
+	    memcpy(new_cursor->C[j].p, C[j].p, B->block_size);
+	    new_cursor->C[j].n = C[j].n;
+	}
+    }
+    RETURN(new_cursor);
+}
+
 bool
 BrassCursor::prev()
 {
@@ -150,6 +150,15 @@ class BrassCursor {
 	/** Destroy the BrassCursor */
 	~BrassCursor();
 
+	/** Create an unpositioned copy of this cursor.
+	 *
+	 *  The blocks this cursor has read are copied into the new cursor
+	 *  (unless the table has changed since they were read), so
+	 *  positioning the copy on a nearby entry will need few or no blocks
+	 *  to be read.
+	 */
+	BrassCursor * clone() const;
+
 	/** Current key pointed to by cursor.
 	 */
 	string current_key;
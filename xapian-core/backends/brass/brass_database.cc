@@ -66,6 +66,7 @@
 #include <algorithm>
 #include "autoptr.h"
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace Xapian;
@@ -108,12 +109,21 @@ BrassDatabase::BrassDatabase(const string &brass_dir, int action,
 	  value_manager(&postlist_table, &termlist_table),
 	  synonym_table(db_dir, readonly),
 	  spelling_table(db_dir, readonly),
+	  permuterm_table(db_dir, readonly),
 	  record_table(db_dir, readonly),
 	  lock(db_dir),
 	  max_changesets(0)
 {
     LOGCALL_CTOR(DB, "BrassDatabase", brass_dir | action | block_size);
 
+    postlist_table.set_permuterm_table(&permuterm_table);
+    // DB_EDGE_NGRAMS only matters if we create the database.
+    unsigned char version_flags = 0;
+    if (action & Xapian::DB_EDGE_NGRAMS)
+	version_flags |= BrassVersion::FLAG_EDGE_NGRAMS;
+    // BrassWritableDatabase handles DB_PERMUTERM.
+    action &= ~(Xapian::DB_PERMUTERM | Xapian::DB_EDGE_NGRAMS);
+
     if (action == XAPIAN_DB_READONLY) {
 	open_tables_consistent();
 	return;
@@ -136,7 +146,7 @@ BrassDatabase::BrassDatabase(const string &brass_dir, int action,
 	}
 	get_database_write_lock(true);
 
-	create_and_open_tables(block_size);
+	create_and_open_tables(block_size, version_flags);
 	return;
     }
 
@@ -149,7 +159,7 @@ BrassDatabase::BrassDatabase(const string &brass_dir, int action,
     get_database_write_lock(false);
     // if we're overwriting, pretend the db doesn't exist
     if (action == Xapian::DB_CREATE_OR_OVERWRITE) {
-	create_and_open_tables(block_size);
+	create_and_open_tables(block_size, version_flags);
 	return;
     }
 
@@ -179,20 +189,22 @@ BrassDatabase::database_exists() {
 }
 
 void
-BrassDatabase::create_and_open_tables(unsigned int block_size)
+BrassDatabase::create_and_open_tables(unsigned int block_size,
+				      unsigned char version_flags)
 {
-    LOGCALL_VOID(DB, "BrassDatabase::create_and_open_tables", NO_ARGS);
+    LOGCALL_VOID(DB, "BrassDatabase::create_and_open_tables", block_size | version_flags);
     // The caller is expected to create the database directory if it doesn't
     // already exist.
 
     // Create postlist_table first, and record_table last.  Existence of
     // record_table is considered to imply existence of the database.
-    version_file.create();
+    version_file.create(version_flags);
     postlist_table.create_and_open(block_size);
     position_table.create_and_open(block_size);
     termlist_table.create_and_open(block_size);
     synonym_table.create_and_open(block_size);
     spelling_table.create_and_open(block_size);
+    permuterm_table.create_and_open(block_size);
     record_table.create_and_open(block_size);
 
     Assert(database_exists());
@@ -238,13 +250,15 @@ BrassDatabase::open_tables_consistent()
     termlist_table.set_block_size(block_size);
     synonym_table.set_block_size(block_size);
     spelling_table.set_block_size(block_size);
+    permuterm_table.set_block_size(block_size);
 
     value_manager.reset();
 
     bool fully_opened = false;
     int tries_left = MAX_OPEN_RETRIES;
     while (!fully_opened && (tries_left--) > 0) {
-	if (spelling_table.open(revision) &&
+	if (permuterm_table.open(revision) &&
+	    spelling_table.open(revision) &&
 	    synonym_table.open(revision) &&
 	    termlist_table.open(revision) &&
 	    position_table.open(revision) &&
@@ -296,9 +310,11 @@ BrassDatabase::open_tables(brass_revision_number_t revision)
     termlist_table.set_block_size(block_size);
     synonym_table.set_block_size(block_size);
     spelling_table.set_block_size(block_size);
+    permuterm_table.set_block_size(block_size);
 
     value_manager.reset();
 
+    permuterm_table.open(revision);
     spelling_table.open(revision);
     synonym_table.open(revision);
     termlist_table.open(revision);
@@ -383,6 +399,7 @@ BrassDatabase::set_revision_number(brass_revision_number_t new_revision)
     termlist_table.flush_db();
     synonym_table.flush_db();
     spelling_table.flush_db();
+    permuterm_table.flush_db();
     record_table.flush_db();
 
     int changes_fd = -1;
@@ -438,6 +455,7 @@ BrassDatabase::set_revision_number(brass_revision_number_t new_revision)
 	    termlist_table.write_changed_blocks(changes_fd, compressed);
 	    synonym_table.write_changed_blocks(changes_fd, compressed);
 	    spelling_table.write_changed_blocks(changes_fd, compressed);
+	    permuterm_table.write_changed_blocks(changes_fd, compressed);
 	    record_table.write_changed_blocks(changes_fd, compressed);
 	    position_table.write_changed_blocks(changes_fd, compressed);
 	    postlist_table.write_changed_blocks(changes_fd, compressed);
@@ -448,6 +466,7 @@ BrassDatabase::set_revision_number(brass_revision_number_t new_revision)
 	termlist_table.commit(new_revision, changes_fd);
 	synonym_table.commit(new_revision, changes_fd);
 	spelling_table.commit(new_revision, changes_fd);
+	permuterm_table.commit(new_revision, changes_fd);
 
 	string changes_tail; // Data to be appended to the changes file
 	if (changes_fd >= 0) {
@@ -502,6 +521,7 @@ BrassDatabase::close()
     termlist_table.close(true);
     synonym_table.close(true);
     spelling_table.close(true);
+    permuterm_table.close(true);
     record_table.close(true);
     lock.release();
 }
@@ -542,6 +562,7 @@ BrassDatabase::send_whole_database(RemoteConnection & conn, double end_time)
 	"\x0b""termlist.DB""\x0e""termlist.baseA\x0e""termlist.baseB"
 	"\x0a""synonym.DB""\x0d""synonym.baseA\x0d""synonym.baseB"
 	"\x0b""spelling.DB""\x0e""spelling.baseA\x0e""spelling.baseB"
+	"\x0c""permuterm.DB""\x0f""permuterm.baseA\x0f""permuterm.baseB"
 	"\x09""record.DB""\x0c""record.baseA\x0c""record.baseB"
 	"\x0b""position.DB""\x0e""position.baseA\x0e""position.baseB"
 	"\x0b""postlist.DB""\x0e""postlist.baseA\x0e""postlist.baseB"
@@ -722,6 +743,7 @@ BrassDatabase::apply()
 	!value_manager.is_modified() &&
 	!synonym_table.is_modified() &&
 	!spelling_table.is_modified() &&
+	!permuterm_table.is_modified() &&
 	!record_table.is_modified()) {
 	return;
     }
@@ -750,6 +772,7 @@ BrassDatabase::cancel()
     value_manager.cancel();
     synonym_table.cancel();
     spelling_table.cancel();
+    permuterm_table.cancel();
     record_table.cancel();
 }
 
@@ -847,7 +870,8 @@ BrassDatabase::get_doclength_upper_bound() const
 Xapian::termcount
 BrassDatabase::get_wdf_upper_bound(const string & term) const
 {
-    return min(get_collection_freq(term), stats.get_wdf_upper_bound());
+    return min(postlist_table.get_wdf_upper_bound(term),
+	       stats.get_wdf_upper_bound());
 }
 
 bool
@@ -937,6 +961,17 @@ BrassDatabase::open_allterms(const string & prefix) const
 				 prefix));
 }
 
+TermList *
+BrassDatabase::open_wildcard_terms(const string & pattern) const
+{
+    LOGCALL(DB, TermList *, "BrassDatabase::open_wildcard_terms", pattern);
+    vector<string> terms;
+    if (!permuterm_table.get_matching_terms(pattern, terms))
+	RETURN(Database::Internal::open_wildcard_terms(pattern));
+    RETURN(new BrassPermutermTermList(intrusive_ptr<const BrassDatabase>(this),
+				      terms));
+}
+
 TermList *
 BrassDatabase::open_spelling_termlist(const string & word) const
 {
@@ -1037,6 +1072,9 @@ BrassWritableDatabase::BrassWritableDatabase(const string &dir, int action,
 	flush_threshold = atoi(p);
     if (flush_threshold == 0)
 	flush_threshold = 10000;
+
+    if ((action & Xapian::DB_PERMUTERM) && !permuterm_table.is_open())
+	build_permuterm_table();
 }
 
 BrassWritableDatabase::~BrassWritableDatabase()
@@ -1045,6 +1083,31 @@ BrassWritableDatabase::~BrassWritableDatabase()
     dtor_called();
 }
 
+void
+BrassWritableDatabase::build_permuterm_table()
+{
+    LOGCALL_VOID(DB, "BrassWritableDatabase::build_permuterm_table", NO_ARGS);
+    permuterm_table.enable();
+
+    AutoPtr<BrassCursor> cursor(postlist_table.cursor_get());
+    (void)cursor->find_entry_ge(string("\x00\xff", 2));
+    string term;
+    while (!cursor->after_end()) {
+	const char *p = cursor->current_key.data();
+	const char *pend = p + cursor->current_key.size();
+	if (!unpack_string_preserving_sort(&p, pend, term)) {
+	    throw Xapian::DatabaseCorruptError("PostList table key has unexpected format");
+	}
+	// Only the key for the first chunk of a postlist is just the term.
+	if (p == pend) permuterm_table.add_term(term);
+	cursor->next();
+    }
+
+    // Commit straight away, so we never have a revision where the table
+    // exists but some of the terms are missing from it.
+    apply();
+}
+
 void
 BrassWritableDatabase::commit()
 {
@@ -1111,7 +1174,7 @@ BrassWritableDatabase::add_document_(Xapian::docid did,
 	    for ( ; term != document.termlist_end(); ++term) {
 		termcount wdf = term.get_wdf();
 		// Calculate the new document length
-		new_doclen += wdf;
+		if (counts_in_doclen(*term)) new_doclen += wdf;
 		stats.check_wdf(wdf);
 
 		string tname = *term;
@@ -1300,7 +1363,7 @@ BrassWritableDatabase::replace_document(Xapian::docid did,
 		if (cmp < 0) {
 		    // Term old_tname has been deleted.
 		    termcount old_wdf = termlist.get_wdf();
-		    new_doclen -= old_wdf;
+		    if (counts_in_doclen(old_tname)) new_doclen -= old_wdf;
 		    inverter.remove_posting(did, old_tname, old_wdf);
 		    if (pos_modified)
 			position_table.delete_positionlist(did, old_tname);
@@ -1308,7 +1371,7 @@ BrassWritableDatabase::replace_document(Xapian::docid did,
 		} else if (cmp > 0) {
 		    // Term new_tname as been added.
 		    termcount new_wdf = term.get_wdf();
-		    new_doclen += new_wdf;
+		    if (counts_in_doclen(new_tname)) new_doclen += new_wdf;
 		    stats.check_wdf(new_wdf);
 		    if (new_tname.size() > MAX_SAFE_TERM_LENGTH)
 			throw Xapian::InvalidArgumentError("Term too long (> "STRINGIZE(MAX_SAFE_TERM_LENGTH)"): " + new_tname);
@@ -1333,7 +1396,8 @@ BrassWritableDatabase::replace_document(Xapian::docid did,
 		    stats.check_wdf(new_wdf);
 
 		    if (old_wdf != new_wdf) {
-		    	new_doclen += new_wdf - old_wdf;
+			if (counts_in_doclen(new_tname))
+			    new_doclen += new_wdf - old_wdf;
 			inverter.update_posting(did, new_tname, old_wdf, new_wdf);
 		    }
 
@@ -1426,6 +1490,16 @@ BrassWritableDatabase::get_collection_freq(const string & term) const
     RETURN(BrassDatabase::get_collection_freq(term) + inverter.get_cfdelta(term));
 }
 
+Xapian::termcount
+BrassWritableDatabase::get_wdf_upper_bound(const string & term) const
+{
+    // Postings which haven't been flushed yet may have a larger wdf than the
+    // bound stored in the table.
+    Xapian::termcount ub = max(postlist_table.get_wdf_upper_bound(term),
+			       inverter.get_wdf_max(term));
+    return min(ub, stats.get_wdf_upper_bound());
+}
+
 Xapian::doccount
 BrassWritableDatabase::get_value_freq(Xapian::valueno slot) const
 {
@@ -1514,6 +1588,21 @@ BrassWritableDatabase::open_allterms(const string & prefix) const
     RETURN(BrassDatabase::open_allterms(prefix));
 }
 
+TermList *
+BrassWritableDatabase::open_wildcard_terms(const string & pattern) const
+{
+    LOGCALL(DB, TermList *, "BrassWritableDatabase::open_wildcard_terms", pattern);
+    if (change_count && permuterm_table.is_open()) {
+	// The permuterm table is updated as posting list changes are flushed,
+	// so flush them all (but don't commit - there may be a transaction in
+	// progress).  As in open_allterms(), set change_count to 1 since the
+	// document length and stats haven't been written.
+	inverter.flush_post_lists(postlist_table, string());
+	change_count = 1;
+    }
+    RETURN(BrassDatabase::open_wildcard_terms(pattern));
+}
+
 void
 BrassWritableDatabase::cancel()
 {
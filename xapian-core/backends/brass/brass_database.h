@@ -28,6 +28,7 @@
 #include "backends/database.h"
 #include "brass_dbstats.h"
 #include "brass_inverter.h"
+#include "brass_permuterm.h"
 #include "brass_positionlist.h"
 #include "brass_postlist.h"
 #include "brass_record.h"
@@ -40,6 +41,7 @@
 #include "brass_types.h"
 #include "backends/valuestats.h"
 
+#include "edgengram.h"
 #include "noreturn.h"
 
 #include <map>
@@ -99,6 +101,12 @@ class BrassDatabase : public Xapian::Database::Internal {
 	 */
 	mutable BrassSpellingTable spelling_table;
 
+	/** Table storing the rotations of each term, for wildcards which
+	 *  don't start with literal text.  Only present if enabled with
+	 *  Xapian::DB_PERMUTERM.
+	 */
+	mutable BrassPermutermTable permuterm_table;
+
 	/** Table storing records.
 	 *
 	 *  Whenever an update is performed, this table is the last to be
@@ -126,8 +134,21 @@ class BrassDatabase : public Xapian::Database::Internal {
 
 	/** Create new tables, and open them.
 	 *  Any existing tables will be removed first.
+	 *
+	 *  @param version_flags	BrassVersion::FLAG_* values to store.
 	 */
-	void create_and_open_tables(unsigned int blocksize);
+	void create_and_open_tables(unsigned int blocksize,
+				    unsigned char version_flags);
+
+	/** Does term @a tname count towards the document length?
+	 *
+	 *  Every term does, except edge n-gram terms in a database created
+	 *  with Xapian::DB_EDGE_NGRAMS.
+	 */
+	bool counts_in_doclen(const std::string & tname) const {
+	    return !(version_file.get_flags() & BrassVersion::FLAG_EDGE_NGRAMS) ||
+		   !is_edge_ngram_term(tname);
+	}
 
 	/** Open all tables at most recent consistent revision.
 	 *
@@ -278,6 +299,7 @@ class BrassDatabase : public Xapian::Database::Internal {
 	PositionList * open_position_list(Xapian::docid did, const string & term) const;
 	TermList * open_term_list(Xapian::docid did) const;
 	TermList * open_allterms(const string & prefix) const;
+	TermList * open_wildcard_terms(const string & pattern) const;
 
 	TermList * open_spelling_termlist(const string & word) const;
 	TermList * open_spelling_wordlist() const;
@@ -329,6 +351,9 @@ class BrassWritableDatabase : public BrassDatabase {
 	/// Flush any unflushed postlist changes, but don't commit them.
 	void flush_postlist_changes() const;
 
+	/// Create the permuterm table and index the existing terms in it.
+	void build_permuterm_table();
+
 	/// Close all the tables permanently.
 	void close();
 
@@ -387,11 +412,13 @@ class BrassWritableDatabase : public BrassDatabase {
 	Xapian::doccount get_value_freq(Xapian::valueno slot) const;
 	std::string get_value_lower_bound(Xapian::valueno slot) const;
 	std::string get_value_upper_bound(Xapian::valueno slot) const;
+	Xapian::termcount get_wdf_upper_bound(const string & term) const;
 	bool term_exists(const string & tname) const;
 
 	LeafPostList * open_post_list(const string & tname) const;
 	ValueList * open_value_list(Xapian::valueno slot) const;
 	TermList * open_allterms(const string & prefix) const;
+	TermList * open_wildcard_terms(const string & pattern) const;
 
 	void add_spelling(const string & word, Xapian::termcount freqinc) const;
 	void remove_spelling(const string & word, Xapian::termcount freqdec) const;
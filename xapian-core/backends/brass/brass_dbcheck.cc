@@ -25,6 +25,7 @@
 #include "brass_dbcheck.h"
 
 #include "bitstream.h"
+#include "edgengram.h"
 
 #include "internaltypes.h"
 
@@ -32,6 +33,7 @@
 #include "brass_cursor.h"
 #include "brass_table.h"
 #include "brass_types.h"
+#include "brass_version.h"
 #include "pack.h"
 #include "backends/valuestats.h"
 
@@ -48,6 +50,30 @@ is_user_metadata_key(const string & key)
     return key.size() > 1 && key[0] == '\0' && key[1] == '\xc0';
 }
 
+/** Check if the database containing table @a filename excludes edge n-grams
+ *  from document lengths.
+ *
+ *  If the version file can't be read (e.g. a table was copied on its own) we
+ *  assume it doesn't.
+ */
+static bool
+edge_ngrams_excluded(const string & filename)
+{
+    string::size_type p = filename.find_last_of('/');
+#if defined __WIN32__ || defined __EMX__
+    if (p == string::npos) p = 0;
+    p = filename.find_last_of('\\', p);
+#endif
+    string dir = (p == string::npos) ? string(".") : string(filename, 0, p);
+    BrassVersion version_file(dir);
+    try {
+	version_file.read_and_check();
+    } catch (const Xapian::DatabaseError &) {
+	return false;
+    }
+    return (version_file.get_flags() & BrassVersion::FLAG_EDGE_NGRAMS);
+}
+
 struct VStats : public ValueStats {
     Xapian::doccount freq_real;
 
@@ -79,7 +105,7 @@ check_brass_table(const char * tablename, string filename, int opts,
 	map<Xapian::valueno, VStats> valuestats;
 	string current_term;
 	Xapian::docid lastdid = 0;
-	Xapian::termcount termfreq = 0, collfreq = 0;
+	Xapian::termcount termfreq = 0, collfreq = 0, wdf_max = 0;
 	Xapian::termcount tf = 0, cf = 0;
 	bool have_metainfo_key = false;
 
@@ -161,12 +187,12 @@ check_brass_table(const char * tablename, string filename, int opts,
 		end = pos + cursor->current_tag.size();
 		if (key.size() == 2) {
 		    // Initial chunk.
-		    if (end - pos < 2 || pos[0] || pos[1]) {
+		    if (end - pos < 3 || pos[0] || pos[1] || pos[2]) {
 			out << "Initial doclen chunk has nonzero dummy fields" << endl;
 			++errors;
 			continue;
 		    }
-		    pos += 2;
+		    pos += 3;
 		    if (!unpack_uint(&pos, end, &did)) {
 			out << "Failed to unpack firstdid for doclen" << endl;
 			++errors;
@@ -440,6 +466,12 @@ check_brass_table(const char * tablename, string filename, int opts,
 		    ++errors;
 		    continue;
 		}
+		if (!unpack_uint(&pos, end, &wdf_max)) {
+		    out << "Failed to unpack wdf upper bound for term '" << term
+			<< "'" << endl;
+		    ++errors;
+		    continue;
+		}
 		if (!unpack_uint(&pos, end, &did)) {
 		    out << "Failed to unpack firstdid for term '" << term
 			<< "'" << endl;
@@ -495,6 +527,11 @@ check_brass_table(const char * tablename, string filename, int opts,
 		}
 		++tf;
 		cf += wdf;
+		if (wdf > wdf_max) {
+		    out << "wdf " << wdf << " > wdf upper bound " << wdf_max
+			<< " for term '" << term << "'" << endl;
+		    ++errors;
+		}
 
 		if (pos == end) break;
 
@@ -571,6 +608,7 @@ check_brass_table(const char * tablename, string filename, int opts,
 	}
     } else if (strcmp(tablename, "termlist") == 0) {
 	// Now check the contents of the termlist table.
+	bool skip_edge_ngrams = edge_ngrams_excluded(filename);
 	for ( ; !cursor->after_end(); cursor->next()) {
 	    string & key = cursor->current_key;
 
@@ -701,7 +739,8 @@ check_brass_table(const char * tablename, string filename, int opts,
 		}
 
 		++actual_termlist_size;
-		actual_doclen += current_wdf;
+		if (!skip_edge_ngrams || !is_edge_ngram_term(current_tname))
+		    actual_doclen += current_wdf;
 	    }
 	    if (bad) {
 		continue;
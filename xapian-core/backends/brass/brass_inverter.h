@@ -49,20 +49,23 @@ class Inverter {
 	/// Change in collection frequency.
 	Xapian::termcount_diff cf_delta;
 
+	/// Largest wdf of any added or updated posting.
+	Xapian::termcount wdf_max;
+
 	/// Changes to this term's postlist.
 	std::map<Xapian::docid, Xapian::termcount> pl_changes;
 
       public:
 	/// Constructor for an added posting.
 	PostingChanges(Xapian::docid did, Xapian::termcount wdf)
-	    : tf_delta(1), cf_delta(Xapian::termcount_diff(wdf))
+	    : tf_delta(1), cf_delta(Xapian::termcount_diff(wdf)), wdf_max(wdf)
 	{
 	    pl_changes.insert(std::make_pair(did, wdf));
 	}
 
 	/// Constructor for a removed posting.
 	PostingChanges(Xapian::docid did, Xapian::termcount wdf, bool)
-	    : tf_delta(-1), cf_delta(-Xapian::termcount_diff(wdf))
+	    : tf_delta(-1), cf_delta(-Xapian::termcount_diff(wdf)), wdf_max(0)
 	{
 	    pl_changes.insert(std::make_pair(did, DELETED_POSTING));
 	}
@@ -70,7 +73,8 @@ class Inverter {
 	/// Constructor for an updated posting.
 	PostingChanges(Xapian::docid did, Xapian::termcount old_wdf,
 		       Xapian::termcount new_wdf)
-	    : tf_delta(0), cf_delta(Xapian::termcount_diff(new_wdf - old_wdf))
+	    : tf_delta(0), cf_delta(Xapian::termcount_diff(new_wdf - old_wdf)),
+	      wdf_max(new_wdf)
 	{
 	    pl_changes.insert(std::make_pair(did, new_wdf));
 	}
@@ -79,6 +83,7 @@ class Inverter {
 	void add_posting(Xapian::docid did, Xapian::termcount wdf) {
 	    ++tf_delta;
 	    cf_delta += wdf;
+	    if (wdf > wdf_max) wdf_max = wdf;
 	    // Add did to term's postlist
 	    pl_changes[did] = wdf;
 	}
@@ -95,6 +100,7 @@ class Inverter {
 	void update_posting(Xapian::docid did, Xapian::termcount old_wdf,
 			    Xapian::termcount new_wdf) {
 	    cf_delta += new_wdf - old_wdf;
+	    if (new_wdf > wdf_max) wdf_max = new_wdf;
 	    pl_changes[did] = new_wdf;
 	}
 
@@ -103,6 +109,9 @@ class Inverter {
 
 	/// Get the collection frequency delta.
 	Xapian::termcount_diff get_cfdelta() const { return cf_delta; }
+
+	/// Get the largest wdf of any added or updated posting.
+	Xapian::termcount get_wdf_max() const { return wdf_max; }
     };
 
     /// Buffered changes to postlists.
@@ -208,6 +217,14 @@ class Inverter {
 	    return 0;
 	return i->second.get_cfdelta();
     }
+
+    Xapian::termcount get_wdf_max(const std::string & term) const {
+	std::map<std::string, PostingChanges>::const_iterator i;
+	i = postlist_changes.find(term);
+	if (i == postlist_changes.end())
+	    return 0;
+	return i->second.get_wdf_max();
+    }
 };
 
 #endif // XAPIAN_INCLUDED_BRASS_INVERTER_H
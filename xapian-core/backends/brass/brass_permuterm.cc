@@ -0,0 +1,196 @@
+/** @file brass_permuterm.cc
+ * @brief Rotated term index for leading and infix wildcards.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <config.h>
+#include "brass_permuterm.h"
+
+#include "xapian/error.h"
+
+#include "autoptr.h"
+#include "backends/wildcardtermlist.h"
+#include "brass_cursor.h"
+#include "debuglog.h"
+#include "pack.h"
+#include "stringutils.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Make the key for rotation @a i of @a term.
+static inline void
+make_rotation_key(string & key, const string & term, size_t i)
+{
+    key.assign(term, i, string::npos);
+    key += '\0';
+    key.append(term, 0, i);
+}
+
+void
+BrassPermutermTable::add_term(const string & term)
+{
+    // The rotations are one byte longer than the term, so a term right at
+    // the key length limit can't be indexed (in practice the postlist key
+    // limits the term length to less than this anyway).
+    if (!is_open() || term.empty() || term.size() >= BRASS_BTREE_MAX_KEY_LEN)
+	return;
+
+    string key, tag;
+    for (size_t i = 0; i <= term.size(); ++i) {
+	make_rotation_key(key, term, i);
+	tag.resize(0);
+	pack_uint_last(tag, i);
+	add(key, tag);
+    }
+}
+
+void
+BrassPermutermTable::remove_term(const string & term)
+{
+    if (!is_open() || term.empty() || term.size() >= BRASS_BTREE_MAX_KEY_LEN)
+	return;
+
+    string key;
+    for (size_t i = 0; i <= term.size(); ++i) {
+	make_rotation_key(key, term, i);
+	del(key);
+    }
+}
+
+bool
+BrassPermutermTable::get_matching_terms(const string & pattern,
+					vector<string> & terms) const
+{
+    LOGCALL(DB, bool, "BrassPermutermTable::get_matching_terms", pattern);
+    if (!is_open()) RETURN(false);
+
+    // Rotate the pattern so that a wildcard is at the end, then look up the
+    // literal text before it.
+    string key;
+    string::size_type first = pattern.find('*');
+    if (first == string::npos) {
+	// No wildcards, so the term must match exactly.
+	key = pattern;
+	key += '\0';
+    } else {
+	string::size_type last = pattern.rfind('*');
+	if (first != 0 || last != pattern.size() - 1) {
+	    // "A*B" (where A or B may be empty) matches terms with rotations
+	    // starting "B\0A".
+	    key.assign(pattern, last + 1, string::npos);
+	    key += '\0';
+	    key.append(pattern, 0, first);
+	} else {
+	    // "*A*" matches terms with rotations starting "A".  If there are
+	    // several runs of literal text, look up the longest since that's
+	    // likely to be the most selective.
+	    string::size_type s = first;
+	    while (s != last) {
+		string::size_type e = pattern.find('*', s + 1);
+		if (e - s - 1 > key.size())
+		    key.assign(pattern, s + 1, e - s - 1);
+		s = e;
+	    }
+	    if (key.empty()) RETURN(false);
+	}
+    }
+
+    // No key this long can be in the table.
+    if (key.size() > BRASS_BTREE_MAX_KEY_LEN) RETURN(true);
+
+    AutoPtr<BrassCursor> cursor(cursor_get());
+    (void)cursor->find_entry_ge(key);
+    string term;
+    while (!cursor->after_end() && startswith(cursor->current_key, key)) {
+	const string & k = cursor->current_key;
+	cursor->read_tag();
+	const char * p = cursor->current_tag.data();
+	const char * end = p + cursor->current_tag.size();
+	size_t i;
+	if (!unpack_uint_last(&p, end, &i) || i >= k.size())
+	    throw Xapian::DatabaseCorruptError("Bad permuterm entry");
+	// The key is T[i..] + '\0' + T[..i].
+	size_t len = k.size() - 1;
+	term.assign(k, len - i + 1, i);
+	term.append(k, 0, len - i);
+	// The key only checks the literal text we looked up, and "*A*" can
+	// match a term more than once, so filter and remove duplicates.
+	if (wildcard_matches(pattern, term))
+	    terms.push_back(term);
+	cursor->next();
+    }
+
+    sort(terms.begin(), terms.end());
+    terms.erase(unique(terms.begin(), terms.end()), terms.end());
+    RETURN(true);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+string
+BrassPermutermTermList::get_termname() const
+{
+    LOGCALL(DB, string, "BrassPermutermTermList::get_termname", NO_ARGS);
+    Assert(!at_end());
+    RETURN(terms[i]);
+}
+
+Xapian::doccount
+BrassPermutermTermList::get_termfreq() const
+{
+    LOGCALL(DB, Xapian::doccount, "BrassPermutermTermList::get_termfreq", NO_ARGS);
+    Assert(!at_end());
+    RETURN(database->get_termfreq(terms[i]));
+}
+
+Xapian::termcount
+BrassPermutermTermList::get_collection_freq() const
+{
+    LOGCALL(DB, Xapian::termcount, "BrassPermutermTermList::get_collection_freq", NO_ARGS);
+    Assert(!at_end());
+    RETURN(database->get_collection_freq(terms[i]));
+}
+
+TermList *
+BrassPermutermTermList::next()
+{
+    LOGCALL(DB, TermList *, "BrassPermutermTermList::next", NO_ARGS);
+    Assert(!at_end());
+    ++i;
+    RETURN(NULL);
+}
+
+TermList *
+BrassPermutermTermList::skip_to(const string & term)
+{
+    LOGCALL(DB, TermList *, "BrassPermutermTermList::skip_to", term);
+    Assert(!at_end());
+    i = lower_bound(terms.begin(), terms.end(), term) - terms.begin();
+    RETURN(NULL);
+}
+
+bool
+BrassPermutermTermList::at_end() const
+{
+    LOGCALL(DB, bool, "BrassPermutermTermList::at_end", NO_ARGS);
+    RETURN(i == terms.size());
+}
@@ -0,0 +1,135 @@
+/** @file brass_permuterm.h
+ * @brief Rotated term index for leading and infix wildcards.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef XAPIAN_INCLUDED_BRASS_PERMUTERM_H
+#define XAPIAN_INCLUDED_BRASS_PERMUTERM_H
+
+#include <xapian/types.h>
+
+#include "backends/alltermslist.h"
+#include "backends/database.h"
+#include "brass_lazytable.h"
+
+#include <string>
+#include <vector>
+
+/** Table of the rotations of each term in the database.
+ *
+ *  For a term T of length L we store the L + 1 keys T[i..] + '\0' + T[..i]
+ *  (for i = 0 to L), with the tag holding i so the term can be recovered
+ *  from any of its rotations.  A pattern "A*B" can then be answered by a
+ *  range scan over keys starting "B\0A", and "*A*" by a scan over keys
+ *  starting "A".
+ *
+ *  The table is optional (it's only created if the database is opened with
+ *  Xapian::DB_PERMUTERM), but once it exists it's kept up to date as terms
+ *  are added to and removed from the database.
+ */
+class BrassPermutermTable : public BrassLazyTable {
+  public:
+    /** Create a new BrassPermutermTable object.
+     *
+     *  This method does not create or open the table on disk - you
+     *  must call the create() or open() methods respectively!
+     *
+     *  @param dbdir		The directory the brass database is stored in.
+     *  @param readonly		true if we're opening read-only, else false.
+     */
+    BrassPermutermTable(const std::string & dbdir, bool readonly)
+	: BrassLazyTable("permuterm", dbdir + "/permuterm.", readonly,
+			 DONT_COMPRESS) { }
+
+    /** Create the table on disk if it doesn't already exist.
+     *
+     *  Unlike the lazy create_and_open(), this actually creates the (empty)
+     *  table so that subsequent changes to the database are indexed.
+     */
+    void enable() {
+	if (!is_open()) BrassTable::create_and_open(get_block_size());
+    }
+
+    /** Add the rotations of a term which is new to the database.
+     *
+     *  Does nothing if the table doesn't exist.
+     */
+    void add_term(const std::string & term);
+
+    /** Remove the rotations of a term which is no longer in the database.
+     *
+     *  Does nothing if the table doesn't exist.
+     */
+    void remove_term(const std::string & term);
+
+    /** Find the terms matching a wildcard pattern.
+     *
+     *  Each '*' in @a pattern matches any sequence of characters.
+     *
+     *  @return false if the table doesn't exist or @a pattern has no
+     *	    literal text to look up (e.g. "*"), in which case the caller
+     *	    needs to scan all the terms instead.
+     */
+    bool get_matching_terms(const std::string & pattern,
+			    std::vector<std::string> & terms) const;
+};
+
+/// Term list for the terms matched in a BrassPermutermTable.
+class BrassPermutermTermList : public AllTermsList {
+    /// Copying is not allowed.
+    BrassPermutermTermList(const BrassPermutermTermList &);
+
+    /// Assignment is not allowed.
+    void operator=(const BrassPermutermTermList &);
+
+    /// Keep a reference to our database to stop it being deleted.
+    Xapian::Internal::intrusive_ptr<const Xapian::Database::Internal> database;
+
+    /// The matching terms, in sorted order.
+    std::vector<std::string> terms;
+
+    /// The current position in terms, or -1 before the first call to next().
+    std::vector<std::string>::size_type i;
+
+  public:
+    /** Construct a BrassPermutermTermList.
+     *
+     *  @param terms_	Matching terms in sorted order, which are swapped
+     *			into the new object.
+     */
+    BrassPermutermTermList(Xapian::Internal::intrusive_ptr<const Xapian::Database::Internal> database_,
+			   std::vector<std::string> & terms_)
+	: database(database_), i(std::vector<std::string>::size_type(-1))
+    {
+	terms.swap(terms_);
+    }
+
+    std::string get_termname() const;
+
+    Xapian::doccount get_termfreq() const;
+
+    Xapian::termcount get_collection_freq() const;
+
+    TermList * next();
+
+    TermList * skip_to(const std::string & term);
+
+    bool at_end() const;
+};
+
+#endif // XAPIAN_INCLUDED_BRASS_PERMUTERM_H
@@ -33,35 +33,72 @@
 
 using Xapian::Internal::intrusive_ptr;
 
-Xapian::doccount
-BrassPostListTable::get_termfreq(const string & term) const
+// How big should chunks in the posting list be?  (They
+// will grow slightly bigger than this, but not more than a
+// few bytes extra) - FIXME: tune this value to try to
+// maximise how well blocks are used.  Or performance.
+// Or indexing speed.  Or something...
+const unsigned int CHUNKSIZE = 2000;
+
+// The longest pack_uint() encoding of a 64-bit value.
+const size_t MAX_PACKED_UINT_LEN = 10;
+
+const BrassPostListTable::TermStats &
+BrassPostListTable::get_term_stats(const string & term) const
 {
-    string key = make_key(term);
+    const TermStats * cached = term_stats_cache.find(term);
+    if (cached) return *cached;
+
+    TermStats stats;
+    stats.termfreq = 0;
+    stats.collfreq = 0;
+    stats.wdf_max = 0;
+    // The statistics are at the start of the first chunk, so we don't need
+    // to read all of it.  Each of the three is at most MAX_PACKED_UINT_LEN
+    // bytes long.
     string tag;
-    if (!get_exact_entry(key, tag)) return 0;
+    if (get_exact_entry_start(make_key(term), tag, 3 * MAX_PACKED_UINT_LEN)) {
+	const char * p = tag.data();
+	BrassPostList::read_number_of_entries(&p, p + tag.size(),
+					      &stats.termfreq, &stats.collfreq,
+					      &stats.wdf_max);
+    }
 
-    Xapian::doccount termfreq;
-    const char * p = tag.data();
-    BrassPostList::read_number_of_entries(&p, p + tag.size(), &termfreq, NULL);
-    return termfreq;
+    TermStats & entry = term_stats_cache.insert(term);
+    entry = stats;
+    return entry;
+}
+
+Xapian::doccount
+BrassPostListTable::get_termfreq(const string & term) const
+{
+    return get_term_stats(term).termfreq;
 }
 
 Xapian::termcount
 BrassPostListTable::get_collection_freq(const string & term) const
 {
-    string key = make_key(term);
-    string tag;
-    if (!get_exact_entry(key, tag)) return 0;
+    return get_term_stats(term).collfreq;
+}
 
-    Xapian::termcount collfreq;
-    const char * p = tag.data();
-    BrassPostList::read_number_of_entries(&p, p + tag.size(), NULL, &collfreq);
-    return collfreq;
+Xapian::termcount
+BrassPostListTable::get_wdf_upper_bound(const string & term) const
+{
+    const TermStats & stats = get_term_stats(term);
+    // The stored bound isn't reduced when postings are removed, so the
+    // collection frequency can be a tighter bound.
+    return min(stats.collfreq, stats.wdf_max);
 }
 
 Xapian::termcount
 BrassPostListTable::get_doclength(Xapian::docid did,
 				  intrusive_ptr<const BrassDatabase> db) const {
+    Xapian::termcount doclen;
+    if (get_cached_doclength(did, doclen)) {
+	if (rare(doclen == DELETED_POSTING))
+	    throw Xapian::DocNotFoundError("Document " + str(did) + " not found");
+	return doclen;
+    }
     if (!doclen_pl.get()) {
 	// Don't keep a reference back to the database, since this
 	// would make a reference loop.
@@ -69,6 +106,7 @@ BrassPostListTable::get_doclength(Xapian::docid did,
     }
     if (!doclen_pl->jump_to(did))
 	throw Xapian::DocNotFoundError("Document " + str(did) + " not found");
+    cache_doclen_chunk();
     return doclen_pl->get_wdf();
 }
 
@@ -76,20 +114,28 @@ bool
 BrassPostListTable::document_exists(Xapian::docid did,
 				    intrusive_ptr<const BrassDatabase> db) const
 {
+    Xapian::termcount doclen;
+    if (get_cached_doclength(did, doclen))
+	return doclen != DELETED_POSTING;
     if (!doclen_pl.get()) {
 	// Don't keep a reference back to the database, since this
 	// would make a reference loop.
 	doclen_pl.reset(new BrassPostList(db, string(), false));
     }
-    return (doclen_pl->jump_to(did));
+    if (!doclen_pl->jump_to(did)) return false;
+    cache_doclen_chunk();
+    return true;
 }
 
-// How big should chunks in the posting list be?  (They
-// will grow slightly bigger than this, but not more than a
-// few bytes extra) - FIXME: tune this value to try to
-// maximise how well blocks are used.  Or performance.
-// Or indexing speed.  Or something...
-const unsigned int CHUNKSIZE = 2000;
+void
+BrassPostListTable::cache_doclen_chunk() const
+{
+    // Chunks are limited in size in bytes, so unless documents have been
+    // deleted the range of docids a doclen chunk covers is bounded.  Don't
+    // cache chunks with large gaps as the array could be huge.
+    doclen_cache_first = doclen_pl->read_chunk_wdfs(doclen_cache,
+						    4 * CHUNKSIZE);
+}
 
 /** PostlistChunkWriter is a wrapper which acts roughly as an
  *  output iterator on a postlist chunk, taking care of the
@@ -193,16 +239,20 @@ static Xapian::docid
 read_start_of_first_chunk(const char ** posptr,
 			  const char * end,
 			  Xapian::doccount * number_of_entries_ptr,
-			  Xapian::termcount * collection_freq_ptr)
+			  Xapian::termcount * collection_freq_ptr,
+			  Xapian::termcount * wdf_max_ptr = NULL)
 {
-    LOGCALL_STATIC(DB, Xapian::docid, "read_start_of_first_chunk", (const void *)posptr | (const void *)end | (void *)number_of_entries_ptr | (void *)collection_freq_ptr);
+    LOGCALL_STATIC(DB, Xapian::docid, "read_start_of_first_chunk", (const void *)posptr | (const void *)end | (void *)number_of_entries_ptr | (void *)collection_freq_ptr | (void *)wdf_max_ptr);
 
     BrassPostList::read_number_of_entries(posptr, end,
-			   number_of_entries_ptr, collection_freq_ptr);
+			   number_of_entries_ptr, collection_freq_ptr,
+			   wdf_max_ptr);
     if (number_of_entries_ptr)
 	LOGVALUE(DB, *number_of_entries_ptr);
     if (collection_freq_ptr)
 	LOGVALUE(DB, *collection_freq_ptr);
+    if (wdf_max_ptr)
+	LOGVALUE(DB, *wdf_max_ptr);
 
     Xapian::docid did;
     // Read the docid of the first entry in the posting list.
@@ -353,11 +403,13 @@ PostlistChunkWriter::append(BrassTable * table, Xapian::docid did,
 static inline string
 make_start_of_first_chunk(Xapian::doccount entries,
 			  Xapian::termcount collectionfreq,
+			  Xapian::termcount wdf_max,
 			  Xapian::docid new_did)
 {
     string chunk;
     pack_uint(chunk, entries);
     pack_uint(chunk, collectionfreq);
+    pack_uint(chunk, wdf_max);
     pack_uint(chunk, new_did - 1);
     return chunk;
 }
@@ -447,14 +499,14 @@ PostlistChunkWriter::flush(BrassTable *table)
 	    // Extract existing counts from the first chunk so we can reinsert
 	    // them into the block we're renaming.
 	    Xapian::doccount num_ent;
-	    Xapian::termcount coll_freq;
+	    Xapian::termcount coll_freq, wdf_max;
 	    {
 		cursor->read_tag();
 		const char *tagpos = cursor->current_tag.data();
 		const char *tagend = tagpos + cursor->current_tag.size();
 
 		(void)read_start_of_first_chunk(&tagpos, tagend,
-						&num_ent, &coll_freq);
+						&num_ent, &coll_freq, &wdf_max);
 	    }
 
 	    // Seek to the next chunk.
@@ -491,7 +543,8 @@ PostlistChunkWriter::flush(BrassTable *table)
 
 	    // And now write it as the first chunk
 	    string tag;
-	    tag = make_start_of_first_chunk(num_ent, coll_freq, new_first_did);
+	    tag = make_start_of_first_chunk(num_ent, coll_freq, wdf_max,
+					    new_first_did);
 	    tag += make_start_of_chunk(new_is_last_chunk,
 					      new_first_did,
 					      new_last_did_in_chunk);
@@ -582,15 +635,16 @@ PostlistChunkWriter::flush(BrassTable *table)
 	    Assert(!tag.empty());
 
 	    Xapian::doccount num_ent;
-	    Xapian::termcount coll_freq;
+	    Xapian::termcount coll_freq, wdf_max;
 	    {
 		const char * tagpos = tag.data();
 		const char * tagend = tagpos + tag.size();
 		(void)read_start_of_first_chunk(&tagpos, tagend,
-						&num_ent, &coll_freq);
+						&num_ent, &coll_freq, &wdf_max);
 	    }
 
-	    tag = make_start_of_first_chunk(num_ent, coll_freq, first_did);
+	    tag = make_start_of_first_chunk(num_ent, coll_freq, wdf_max,
+					    first_did);
 
 	    tag += make_start_of_chunk(is_last_chunk, first_did, current_did);
 	    tag += chunk;
@@ -646,12 +700,15 @@ PostlistChunkWriter::flush(BrassTable *table)
 void BrassPostList::read_number_of_entries(const char ** posptr,
 				   const char * end,
 				   Xapian::doccount * number_of_entries_ptr,
-				   Xapian::termcount * collection_freq_ptr)
+				   Xapian::termcount * collection_freq_ptr,
+				   Xapian::termcount * wdf_max_ptr)
 {
     if (!unpack_uint(posptr, end, number_of_entries_ptr))
 	report_read_error(*posptr);
     if (!unpack_uint(posptr, end, collection_freq_ptr))
 	report_read_error(*posptr);
+    if (!unpack_uint(posptr, end, wdf_max_ptr))
+	report_read_error(*posptr);
 }
 
 /** The format of a postlist is:
@@ -670,8 +727,11 @@ void BrassPostList::read_number_of_entries(const char ** posptr,
  *  5)  (4) repeatedly.
  *
  *  The first chunk begins with the number of entries, the collection
- *  frequency, then the docid of the first document, then has the header of a
- *  standard chunk.
+ *  frequency, an upper bound on the wdf, then the docid of the first
+ *  document, then has the header of a standard chunk.  The wdf bound is
+ *  only ever increased as postings are added, so is the largest wdf the
+ *  term has had since the postlist was created (or last compacted).  The
+ *  document length list always stores 0 here.
  */
 BrassPostList::BrassPostList(intrusive_ptr<const BrassDatabase> this_db_,
 			     const string & term_,
@@ -683,6 +743,25 @@ BrassPostList::BrassPostList(intrusive_ptr<const BrassDatabase> this_db_,
 	  cursor(this_db_->postlist_table.cursor_get())
 {
     LOGCALL_CTOR(DB, "BrassPostList", this_db_.get() | term_ | keep_reference);
+    init();
+}
+
+BrassPostList::BrassPostList(intrusive_ptr<const BrassDatabase> this_db_,
+			     const string & term_,
+			     BrassCursor * cursor_)
+	: LeafPostList(term_),
+	  this_db(this_db_),
+	  have_started(false),
+	  is_at_end(false),
+	  cursor(cursor_)
+{
+    LOGCALL_CTOR(DB, "BrassPostList", this_db_.get() | term_ | (void*)cursor_);
+    init();
+}
+
+void
+BrassPostList::init()
+{
     string key = BrassPostListTable::make_key(term);
     int found = cursor->find_entry(key);
     if (!found) {
@@ -712,6 +791,19 @@ BrassPostList::~BrassPostList()
     LOGCALL_DTOR(DB, "BrassPostList");
 }
 
+LeafPostList *
+BrassPostList::open_nearby_postlist(const std::string & term_) const
+{
+    LOGCALL(DB, LeafPostList *, "BrassPostList::open_nearby_postlist", term_);
+    if (term_.empty()) RETURN(NULL);
+    // A writable database may have buffered changes for term_ which need to
+    // be flushed first, so leave it to open the postlist the usual way.
+    if (!this_db.get() || !this_db->readonly) RETURN(NULL);
+    // Copy our cursor, so the blocks it has read can be reused to find the
+    // new term's postlist.
+    RETURN(new BrassPostList(this_db, term_, cursor->clone()));
+}
+
 Xapian::termcount
 BrassPostList::get_doclength() const
 {
@@ -971,6 +1063,50 @@ BrassPostList::jump_to(Xapian::docid desired_did)
     RETURN(desired_did == did);
 }
 
+Xapian::docid
+BrassPostList::read_chunk_wdfs(vector<Xapian::termcount> & wdfs,
+			       Xapian::docid max_range) const
+{
+    LOGCALL(DB, Xapian::docid, "BrassPostList::read_chunk_wdfs", (void*)&wdfs | max_range);
+    Assert(have_started);
+    Assert(!is_at_end);
+    if (last_did_in_chunk - first_did_in_chunk >= max_range) {
+	wdfs.clear();
+	RETURN(0);
+    }
+
+    // Skip the chunk header(s) at the start of the tag.
+    const char * keypos = cursor->current_key.data();
+    const char * keyend = keypos + cursor->current_key.size();
+    (void)check_tname_in_key_lite(&keypos, keyend, term);
+    const char * p = cursor->current_tag.data();
+    const char * e = p + cursor->current_tag.size();
+    if (keypos == keyend)
+	(void)read_start_of_first_chunk(&p, e, NULL, NULL);
+    bool dummy;
+    (void)read_start_of_chunk(&p, e, first_did_in_chunk, &dummy);
+
+    wdfs.assign(last_did_in_chunk - first_did_in_chunk + 1, DELETED_POSTING);
+    Xapian::docid d = first_did_in_chunk;
+    Xapian::termcount w;
+    read_wdf(&p, e, &w);
+    wdfs[0] = w;
+    while (p != e) {
+	read_did_increase(&p, e, &d);
+	read_wdf(&p, e, &w);
+	// Unsigned arithmetic means this also catches d wrapping around.
+	Xapian::docid offset = d - first_did_in_chunk;
+	if (rare(offset >= wdfs.size())) {
+	    throw Xapian::DatabaseCorruptError("Document ID in postlist chunk (" +
+		    str(d) +
+		    ") is greater than last document ID in the chunk (" +
+		    str(last_did_in_chunk) + ")");
+	}
+	wdfs[offset] = w;
+    }
+    RETURN(first_did_in_chunk);
+}
+
 string
 BrassPostList::get_description() const
 {
@@ -1069,6 +1205,7 @@ BrassPostListTable::merge_doclen_changes(const map<Xapian::docid, Xapian::termco
 
     // The cursor in the doclen_pl will no longer be valid, so reset it.
     doclen_pl.reset(0);
+    doclen_cache.clear();
 
     LOGVALUE(DB, doclens.size());
     if (doclens.empty()) return;
@@ -1077,7 +1214,7 @@ BrassPostListTable::merge_doclen_changes(const map<Xapian::docid, Xapian::termco
     string current_key = make_key(string());
     if (!key_exists(current_key)) {
 	LOGLINE(DB, "Adding dummy first chunk");
-	string newtag = make_start_of_first_chunk(0, 0, 0);
+	string newtag = make_start_of_first_chunk(0, 0, 0, 0);
 	newtag += make_start_of_chunk(true, 0, 0);
 	add(current_key, newtag);
     }
@@ -1134,6 +1271,7 @@ void
 BrassPostListTable::merge_changes(const string &term,
 				  const Inverter::PostingChanges & changes)
 {
+    term_stats_cache.erase(term);
     {
 	// Rewrite the first chunk of this posting list with the updated
 	// termfreq and collfreq.
@@ -1145,24 +1283,29 @@ BrassPostListTable::merge_changes(const string &term,
 	const char *pos = tag.data();
 	const char *end = pos + tag.size();
 	Xapian::doccount termfreq;
-	Xapian::termcount collfreq;
+	Xapian::termcount collfreq, wdf_max;
 	Xapian::docid firstdid, lastdid;
 	bool islast;
 	if (pos == end) {
 	    termfreq = 0;
 	    collfreq = 0;
+	    wdf_max = 0;
 	    firstdid = 0;
 	    lastdid = 0;
 	    islast = true;
 	} else {
 	    firstdid = read_start_of_first_chunk(&pos, end,
-						 &termfreq, &collfreq);
+						 &termfreq, &collfreq,
+						 &wdf_max);
 	    // Handle the generic start of chunk header.
 	    lastdid = read_start_of_chunk(&pos, end, firstdid, &islast);
 	}
 
 	termfreq += changes.get_tfdelta();
 	if (termfreq == 0) {
+	    // The term is no longer in the database.
+	    if (permuterm_table && !tag.empty())
+		permuterm_table->remove_term(term);
 	    // All postings deleted!  So we can shortcut by zapping the
 	    // posting list.
 	    if (islast) {
@@ -1182,17 +1325,27 @@ BrassPostListTable::merge_changes(const string &term,
 	    return;
 	}
 	collfreq += changes.get_cfdelta();
+	wdf_max = max(wdf_max, changes.get_wdf_max());
 
-	// Rewrite start of first chunk to update termfreq and collfreq.
-	string newhdr = make_start_of_first_chunk(termfreq, collfreq, firstdid);
-	newhdr += make_start_of_chunk(islast, firstdid, lastdid);
 	if (pos == end) {
-	    add(current_key, newhdr);
-	} else {
-	    Assert((size_t)(pos - tag.data()) <= tag.size());
-	    tag.replace(0, pos - tag.data(), newhdr);
-	    add(current_key, tag);
+	    // This term isn't in the table yet, which is the case for most
+	    // terms when building a database from scratch.  Rather than adding
+	    // an empty first chunk and then reading it back to merge in the
+	    // changes, we can just write out the new postlist.
+	    if (permuterm_table) permuterm_table->add_term(term);
+	    add_new_postlist(term, termfreq, collfreq, wdf_max,
+			     changes.pl_changes);
+	    return;
 	}
+
+	// Rewrite start of first chunk to update termfreq, collfreq and the
+	// wdf bound.
+	string newhdr = make_start_of_first_chunk(termfreq, collfreq, wdf_max,
+						  firstdid);
+	newhdr += make_start_of_chunk(islast, firstdid, lastdid);
+	Assert((size_t)(pos - tag.data()) <= tag.size());
+	tag.replace(0, pos - tag.data(), newhdr);
+	add(current_key, tag);
     }
     map<Xapian::docid, Xapian::termcount>::const_iterator j;
     j = changes.pl_changes.begin();
@@ -1242,3 +1395,64 @@ next_chunk:
     to->flush(this);
     delete to;
 }
+
+void
+BrassPostListTable::add_new_postlist(const string &term,
+				     Xapian::doccount termfreq,
+				     Xapian::termcount collfreq,
+				     Xapian::termcount wdf_max,
+				     const map<Xapian::docid, Xapian::termcount> & postings)
+{
+    LOGCALL_VOID(DB, "BrassPostListTable::add_new_postlist", term | termfreq | collfreq | wdf_max | postings);
+    term_stats_cache.erase(term);
+
+    // This produces the same chunks as PostlistChunkWriter would.
+    string chunk;
+    Xapian::docid first_did = 0, last_did = 0;
+    bool is_first_chunk = true;
+    map<Xapian::docid, Xapian::termcount>::const_iterator j;
+    for (j = postings.begin(); j != postings.end(); ++j) {
+	Xapian::docid did = j->first;
+	Xapian::termcount wdf = j->second;
+	// A document can be added and deleted again between flushes.
+	if (wdf == DELETED_POSTING) continue;
+	if (first_did == 0) {
+	    first_did = did;
+	} else if (chunk.size() >= CHUNKSIZE) {
+	    // Start a new chunk if this one has grown to the threshold.
+	    string tag;
+	    if (is_first_chunk) {
+		tag = make_start_of_first_chunk(termfreq, collfreq, wdf_max,
+						first_did);
+		tag += make_start_of_chunk(false, first_did, last_did);
+		tag += chunk;
+		add(make_key(term), tag);
+		is_first_chunk = false;
+	    } else {
+		tag = make_start_of_chunk(false, first_did, last_did);
+		tag += chunk;
+		add(make_key(term, first_did), tag);
+	    }
+	    first_did = did;
+	    chunk.resize(0);
+	} else {
+	    pack_uint(chunk, did - last_did - 1);
+	}
+	last_did = did;
+	pack_uint(chunk, wdf);
+    }
+    AssertRel(first_did,>,0);
+
+    string tag;
+    if (is_first_chunk) {
+	tag = make_start_of_first_chunk(termfreq, collfreq, wdf_max,
+					first_did);
+	tag += make_start_of_chunk(true, first_did, last_did);
+	tag += chunk;
+	add(make_key(term), tag);
+    } else {
+	tag = make_start_of_chunk(true, first_did, last_did);
+	tag += chunk;
+	add(make_key(term, first_did), tag);
+    }
+}
@@ -34,13 +34,16 @@
 #include "omassert.h"
 
 #include "autoptr.h"
+#include "boundedcache.h"
 #include <map>
 #include <string>
+#include <vector>
 
 using namespace std;
 
 class BrassCursor;
 class BrassDatabase;
+class BrassPermutermTable;
 
 namespace Brass {
     class PostlistChunkReader;
@@ -53,6 +56,63 @@ class BrassPostListTable : public BrassTable {
 	/// PostList for looking up document lengths.
 	mutable AutoPtr<BrassPostList> doclen_pl;
 
+	/** Document lengths from the doclen chunk last looked up.
+	 *
+	 *  Indexed by docid - doclen_cache_first, with DELETED_POSTING for
+	 *  docids which don't exist.
+	 */
+	mutable std::vector<Xapian::termcount> doclen_cache;
+
+	/// The docid of the first entry in doclen_cache.
+	mutable Xapian::docid doclen_cache_first;
+
+	/** Look up the length of document @a did in doclen_cache.
+	 *
+	 *  @return true if @a did is in the range of docids cached, in which
+	 *	    case @a doclen is set (to DELETED_POSTING if there's no such
+	 *	    document).
+	 */
+	bool get_cached_doclength(Xapian::docid did,
+				  Xapian::termcount & doclen) const {
+	    Xapian::docid offset = did - doclen_cache_first;
+	    if (offset >= doclen_cache.size()) return false;
+	    doclen = doclen_cache[offset];
+	    return true;
+	}
+
+	/// Fill doclen_cache from the chunk doclen_pl is positioned in.
+	void cache_doclen_chunk() const;
+
+	/// The statistics stored at the start of a term's postlist.
+	struct TermStats {
+	    Xapian::doccount termfreq;
+	    Xapian::termcount collfreq;
+	    Xapian::termcount wdf_max;
+	};
+
+	/** Statistics for the terms looked up since the table was opened.
+	 *
+	 *  Terms which don't exist are cached with all the statistics zero.
+	 *  Query planning and weighting look up the same few terms several
+	 *  times, and often again for the next query, so this saves finding
+	 *  them in the Btree each time.
+	 *
+	 *  Entries are small (the term and three counts), but a single
+	 *  wildcard or partial query can look up thousands of terms, so we keep
+	 *  up to 10000 to avoid the cache being emptied part way through such a
+	 *  query.
+	 */
+	mutable BoundedCache<std::string, TermStats, 10000> term_stats_cache;
+
+	/// Look up the statistics for @a term, using term_stats_cache.
+	const TermStats & get_term_stats(const std::string & term) const;
+
+	/** Rotated term index to keep in step with the terms in this table.
+	 *
+	 *  May be NULL, and does nothing if the table doesn't exist.
+	 */
+	BrassPermutermTable * permuterm_table;
+
     public:
 	/** Create a new table object.
 	 *
@@ -68,17 +128,48 @@ class BrassPostListTable : public BrassTable {
 	 */
 	BrassPostListTable(const string & path_, bool readonly_)
 	    : BrassTable("postlist", path_ + "/postlist.", readonly_),
-	      doclen_pl()
+	      doclen_pl(), doclen_cache_first(0), permuterm_table(NULL)
 	{ }
 
+	/// Set the rotated term index to update as terms come and go.
+	void set_permuterm_table(BrassPermutermTable * permuterm_table_) {
+	    permuterm_table = permuterm_table_;
+	}
+
 	bool open(brass_revision_number_t revno) {
 	    doclen_pl.reset(0);
+	    doclen_cache.clear();
+	    term_stats_cache.clear();
 	    return BrassTable::open(revno);
 	}
 
+	void close(bool permanent = false) {
+	    doclen_cache.clear();
+	    term_stats_cache.clear();
+	    BrassTable::close(permanent);
+	}
+
+	void cancel() {
+	    doclen_pl.reset(0);
+	    doclen_cache.clear();
+	    term_stats_cache.clear();
+	    BrassTable::cancel();
+	}
+
 	/// Merge changes for a term.
 	void merge_changes(const string &term, const Inverter::PostingChanges & changes);
 
+	/** Write out the postlist for a term which isn't yet in the table.
+	 *
+	 *  This is merge_changes()'s fast path for new terms, so @a postings
+	 *  may contain DELETED_POSTING entries, which are skipped.
+	 */
+	void add_new_postlist(const string &term,
+			      Xapian::doccount termfreq,
+			      Xapian::termcount collfreq,
+			      Xapian::termcount wdf_max,
+			      const map<Xapian::docid, Xapian::termcount> & postings);
+
 	/// Merge document length changes.
 	void merge_doclen_changes(const map<Xapian::docid, Xapian::termcount> & doclens);
 
@@ -113,6 +204,14 @@ class BrassPostListTable : public BrassTable {
 	 */
 	Xapian::termcount get_collection_freq(const std::string & term) const;
 
+	/** Returns an upper bound on the wdf of @a term.
+	 *
+	 *  This uses the largest wdf the term has had in any document since
+	 *  the postlist was created, so it may be higher than the current
+	 *  largest wdf if documents have since been deleted or modified.
+	 */
+	Xapian::termcount get_wdf_upper_bound(const std::string & term) const;
+
 	/** Returns the length of document @a did. */
 	Xapian::termcount get_doclength(Xapian::docid did,
 					Xapian::Internal::intrusive_ptr<const BrassDatabase> db) const;
@@ -220,12 +319,20 @@ class BrassPostList : public LeafPostList {
 	 */
 	bool move_forward_in_chunk_to_at_least(Xapian::docid desired_did);
 
+	/// Position the cursor on the first chunk and read its header.
+	void init();
+
     public:
 	/// Default constructor.
 	BrassPostList(Xapian::Internal::intrusive_ptr<const BrassDatabase> this_db_,
 		      const string & term,
 		      bool keep_reference);
 
+	/// Construct using @a cursor_, which we take ownership of.
+	BrassPostList(Xapian::Internal::intrusive_ptr<const BrassDatabase> this_db_,
+		      const string & term,
+		      BrassCursor * cursor_);
+
 	/// Destructor.
 	~BrassPostList();
 
@@ -235,12 +342,25 @@ class BrassPostList : public LeafPostList {
 	 */
 	bool jump_to(Xapian::docid desired_did);
 
+	/** Decode all the entries in the current chunk.
+	 *
+	 *  Used to cache doclens.  @a wdfs is indexed by docid minus the first
+	 *  docid in the chunk (which is returned), with DELETED_POSTING for
+	 *  docids in the range of the chunk which aren't present.  If the
+	 *  chunk covers more than @a max_range docids, @a wdfs is cleared and
+	 *  0 returned.
+	 */
+	Xapian::docid read_chunk_wdfs(std::vector<Xapian::termcount> & wdfs,
+				      Xapian::docid max_range) const;
+
 	/** Returns number of docs indexed by this term.
 	 *
 	 *  This is the length of the postlist.
 	 */
 	Xapian::doccount get_termfreq() const { return number_of_entries; }
 
+	LeafPostList * open_nearby_postlist(const std::string & term_) const;
+
 	/// Returns the current docid.
 	Xapian::docid get_docid() const { Assert(have_started); return did; }
 
@@ -272,11 +392,12 @@ class BrassPostList : public LeafPostList {
 	/// Get a description of the document.
 	std::string get_description() const;
 
-	/// Read the number of entries and the collection frequency.
+	/// Read the number of entries, the collection frequency and wdf bound.
 	static void read_number_of_entries(const char ** posptr,
 					   const char * end,
 					   Xapian::doccount * number_of_entries_ptr,
-					   Xapian::termcount * collection_freq_ptr);
+					   Xapian::termcount * collection_freq_ptr,
+					   Xapian::termcount * wdf_max_ptr = NULL);
 };
 
 #endif /* OM_HGUARD_BRASS_POSTLIST_H */
@@ -59,6 +59,7 @@ BrassSynonymTable::merge_changes()
 	add(last_term, tag);
 	last_synonyms.clear();
     }
+    synonyms_cache.erase(last_term);
     last_term.resize(0);
 }
 
@@ -133,34 +134,38 @@ BrassSynonymTable::clear_synonyms(const string & term)
 TermList *
 BrassSynonymTable::open_termlist(const string & term)
 {
-    vector<string> synonyms;
-
     if (last_term == term) {
 	if (last_synonyms.empty()) return NULL;
 
-	synonyms.reserve(last_synonyms.size());
-	set<string>::const_iterator i;
-	for (i = last_synonyms.begin(); i != last_synonyms.end(); ++i) {
-	    synonyms.push_back(*i);
-	}
-    } else {
+	return new VectorTermList(last_synonyms.begin(), last_synonyms.end());
+    }
+
+    vector<string> * cached = synonyms_cache.find(term);
+    if (!cached) {
+	vector<string> synonyms;
 	string tag;
-	if (!get_exact_entry(term, tag)) return NULL;
-
-	const char * p = tag.data();
-	const char * end = p + tag.size();
-	while (p != end) {
-	    size_t len;
-	    if (p == end ||
-		(len = byte(*p) ^ MAGIC_XOR_VALUE) >= size_t(end - p))
-		throw Xapian::DatabaseCorruptError("Bad synonym data");
-	    ++p;
-	    synonyms.push_back(string(p, len));
-	    p += len;
+	if (get_exact_entry(term, tag)) {
+	    const char * p = tag.data();
+	    const char * end = p + tag.size();
+	    while (p != end) {
+		size_t len;
+		if (p == end ||
+		    (len = byte(*p) ^ MAGIC_XOR_VALUE) >= size_t(end - p))
+		    throw Xapian::DatabaseCorruptError("Bad synonym data");
+		++p;
+		synonyms.push_back(string(p, len));
+		p += len;
+	    }
 	}
+
+	cached = &synonyms_cache.insert(term);
+	// Swap rather than copy the list into the cache.
+	cached->swap(synonyms);
     }
 
-    return new VectorTermList(synonyms.begin(), synonyms.end());
+    if (cached->empty()) return NULL;
+
+    return new VectorTermList(cached->begin(), cached->end());
 }
 
 ///////////////////////////////////////////////////////////////////////////
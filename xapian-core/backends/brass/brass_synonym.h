@@ -27,9 +27,11 @@
 #include "backends/database.h"
 #include "brass_lazytable.h"
 #include "api/termlist.h"
+#include "boundedcache.h"
 
 #include <set>
 #include <string>
+#include <vector>
 
 class BrassSynonymTable : public BrassLazyTable {
     /// The last term which was updated.
@@ -38,6 +40,17 @@ class BrassSynonymTable : public BrassLazyTable {
     /// The synonyms for the last term which was updated.
     mutable std::set<std::string> last_synonyms;
 
+    /** Synonyms for terms looked up since the table was opened.
+     *
+     *  Terms with no synonyms are cached with an empty list, which is the
+     *  common case when the QueryParser checks every term in a query.
+     *
+     *  Only terms from queries get looked up, a few for each word parsed, so
+     *  1000 entries covers the words of many recent queries.  An entry can
+     *  hold a long list of synonyms, so we don't keep more than that.
+     */
+    BoundedCache<std::string, std::vector<std::string>, 1000> synonyms_cache;
+
   public:
     /** Create a new BrassSynonymTable object.
      *
@@ -58,6 +71,7 @@ class BrassSynonymTable : public BrassLazyTable {
     void discard_changes() {
 	last_term.resize(0);
 	last_synonyms.clear();
+	synonyms_cache.clear();
     }
 
     /** Add a synonym for @a term.
@@ -91,6 +105,16 @@ class BrassSynonymTable : public BrassLazyTable {
      *  @{
      */
 
+    bool open(brass_revision_number_t revision) {
+	synonyms_cache.clear();
+	return BrassTable::open(revision);
+    }
+
+    void close(bool permanent = false) {
+	synonyms_cache.clear();
+	BrassTable::close(permanent);
+    }
+
     bool is_modified() const {
 	return !last_term.empty() || BrassTable::is_modified();
     }
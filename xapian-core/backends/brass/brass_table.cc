@@ -31,6 +31,7 @@
 
 #include "omassert.h"
 #include "posixy_wrapper.h"
+#include "safesysstat.h"
 #include "str.h"
 #include "stringutils.h" // For STRINGIZE().
 
@@ -48,6 +49,9 @@
 // #define DANGEROUS
 
 #include <sys/types.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
 
 // Trying to include the correct headers with the correct defines set to
 // get pread() and pwrite() prototyped on every platform without breaking any
@@ -62,6 +66,7 @@ PWRITE_PROTOTYPE
 #endif
 
 #include <cstdio>    /* for rename */
+#include <cstdlib>   /* for atoi, getenv */
 #include <cstring>   /* for memmove */
 #include <climits>   /* for CHAR_BIT */
 
@@ -84,6 +89,12 @@ using namespace std;
 // Only try to compress tags longer than this many bytes.
 const size_t COMPRESS_MIN = 4;
 
+// By default, only store a tag compressed if that saves at least
+// 1/COMPRESS_MIN_SAVING of its size.  Otherwise every read has to inflate it
+// for little saving in I/O, so we store it as it is and reads can use it
+// directly.  Subclasses can set compress_min_saving to change this.
+const size_t COMPRESS_MIN_SAVING = 8;
+
 //#define BTREE_DEBUG_FULL 1
 #undef BTREE_DEBUG_FULL
 
@@ -189,6 +200,15 @@ BrassTable::read_block(uint4 n, byte * p) const
      */
     Assert(n / CHAR_BIT < base.get_bit_map_size());
 
+    if (map_addr) {
+	size_t offset = size_t(block_size) * n;
+	// Blocks added since we mapped the file are read in the normal way.
+	if (offset + block_size <= map_size) {
+	    memcpy(p, map_addr + offset, block_size);
+	    return;
+	}
+    }
+
 #ifdef HAVE_PREAD
     off_t offset = off_t(block_size) * n;
     int m = block_size;
@@ -735,7 +755,14 @@ BrassTable::add_item(Item_wr kt_, int j)
 	}
 
 	uint4 split_n = C[j].n;
-	C[j].n = base.next_free_block();
+	if (j == 0 && seq_count >= 0) {
+	    // During sequential addition, try to put the new leaf block
+	    // straight after the one we're splitting off so that reading
+	    // through the table later accesses the file sequentially.
+	    C[j].n = base.next_free_block_after(split_n);
+	} else {
+	    C[j].n = base.next_free_block();
+	}
 
 	memcpy(split_p, p, block_size);  // replicate the whole block in split_p
 	SET_DIR_END(split_p, m);
@@ -1032,26 +1059,19 @@ BrassTable::add(const string &key, string tag, bool already_compressed)
 
 	comp_stream.lazy_alloc_deflate_zstream();
 
-	comp_stream.deflate_zstream->next_in = (Bytef *)const_cast<char *>(tag.data());
-	comp_stream.deflate_zstream->avail_in = (uInt)tag.size();
-
-	// If compressed size is >= tag.size(), we don't want to compress.
-	unsigned long blk_len = tag.size() - 1;
-	unsigned char * blk = new unsigned char[blk_len];
-	comp_stream.deflate_zstream->next_out = blk;
-	comp_stream.deflate_zstream->avail_out = (uInt)blk_len;
-
-	int err = deflate(comp_stream.deflate_zstream, Z_FINISH);
-	if (err == Z_STREAM_END) {
-	    // If deflate succeeded, then the output was at least one byte
-	    // smaller than the input.
-	    tag.assign(reinterpret_cast<const char *>(blk), comp_stream.deflate_zstream->total_out);
+	// Limit the output to the size which would make compressing the tag
+	// worthwhile, so that deflate gives up early on data which doesn't
+	// compress well.  compress() reuses its output buffer between calls.
+	size_t max_out = tag.size() - 1 - tag.size() / compress_min_saving;
+	comp_stream.compress(tag, max_out);
+	if (comp_stream.zerr == Z_STREAM_END) {
+	    tag.assign(reinterpret_cast<const char *>(comp_stream.out),
+		       comp_stream.deflate_zstream->total_out);
 	    compressed = true;
 	} else {
-	    // Deflate failed - presumably the data wasn't compressible.
+	    // Deflate ran out of space - the data didn't compress enough to be
+	    // worth inflating on every read.
 	}
-
-	delete [] blk;
     }
 
     // sort of matching kt.append_chunk(), but setting the chunk
@@ -1190,6 +1210,46 @@ BrassTable::get_exact_entry(const string &key, string & tag) const
     RETURN(true);
 }
 
+bool
+BrassTable::get_exact_entry_start(const string &key, string & tag,
+				  size_t min_len) const
+{
+    LOGCALL(DB, bool, "BrassTable::get_exact_entry_start", key | tag | min_len);
+    Assert(!key.empty());
+
+    if (handle < 0) {
+	if (handle == -2) {
+	    BrassTable::throw_database_closed();
+	}
+	RETURN(false);
+    }
+
+    // An oversized key can't exist, so attempting to search for it should fail.
+    if (key.size() > BRASS_BTREE_MAX_KEY_LEN) RETURN(false);
+
+    form_key(key);
+    if (!find(C)) RETURN(false);
+
+    Item item(C[0].p, C[0].c);
+    if (item.get_compressed()) {
+	// We can't decompress just part of the tag.
+	(void)read_tag(C, &tag, false);
+    } else {
+	tag.resize(0);
+	item.append_chunk(&tag);
+	// add() may put only a few bytes of a new tag in its first item, so
+	// read on until we have min_len bytes or the whole tag.
+	int n = item.components_of();
+	for (int i = 2; i <= n && tag.size() < min_len; ++i) {
+	    if (!next(C, 0)) {
+		throw Xapian::DatabaseCorruptError("Unexpected end of table when reading continuation of tag");
+	    }
+	    (void)Item(C[0].p, C[0].c).append_chunk(&tag);
+	}
+    }
+    RETURN(true);
+}
+
 bool
 BrassTable::key_exists(const string &key) const
 {
@@ -1549,6 +1609,8 @@ BrassTable::BrassTable(const char * tablename_, const string & path_,
 	  faked_root_block(true),
 	  sequential(true),
 	  handle(-1),
+	  map_addr(0),
+	  map_size(0),
 	  level(0),
 	  root(0),
 	  kt(0),
@@ -1566,6 +1628,7 @@ BrassTable::BrassTable(const char * tablename_, const string & path_,
 	  cursor_version(0),
 	  split_p(0),
 	  compress_strategy(compress_strategy_),
+	  compress_min_saving(COMPRESS_MIN_SAVING),
 	  comp_stream(compress_strategy_),
 	  lazy(lazy_)
 {
@@ -1644,6 +1707,14 @@ BrassTable::~BrassTable() {
 void BrassTable::close(bool permanent) {
     LOGCALL_VOID(DB, "BrassTable::close", NO_ARGS);
 
+#ifdef HAVE_MMAP
+    if (map_addr) {
+	(void)munmap(const_cast<byte *>(map_addr), map_size);
+	map_addr = 0;
+	map_size = 0;
+    }
+#endif
+
     if (handle >= 0) {
 	// If an error occurs here, we just ignore it, since we're just
 	// trying to free everything.
@@ -1691,6 +1762,12 @@ BrassTable::flush_db()
     if (Btree_modified) {
 	faked_root_block = false;
     }
+
+    // Get the kernel started on writing out the blocks now.  The tables are
+    // all flushed before any of them are committed, so this allows the
+    // writes to the different tables to proceed in parallel, and the
+    // io_sync() calls in commit() then only need to wait for them.
+    io_sync_start(handle);
 }
 
 void
@@ -1936,6 +2013,8 @@ BrassTable::do_open_to_read(bool revision_supplied, brass_revision_number_t revi
 	throw Xapian::DatabaseOpeningError("Failed to open table for reading");
     }
 
+    map_table();
+
     for (int j = 0; j <= level; j++) {
 	C[j].n = BLK_UNUSED;
 	C[j].p = new byte[block_size];
@@ -1945,6 +2024,37 @@ BrassTable::do_open_to_read(bool revision_supplied, brass_revision_number_t revi
     RETURN(true);
 }
 
+void
+BrassTable::map_table()
+{
+    LOGCALL_VOID(DB, "BrassTable::map_table", NO_ARGS);
+    Assert(!writable);
+    Assert(!map_addr);
+#ifdef HAVE_MMAP
+    // This is opt-in, since if the file gets truncated while we have it
+    // mapped (e.g. by the database being overwritten with
+    // DB_CREATE_OR_OVERWRITE) then accessing the mapping will cause SIGBUS
+    // rather than a DatabaseError being thrown.  It's intended for databases
+    // which are known not to be modified while being searched, such as
+    // read-only snapshots produced by xapian-compact.
+    const char *p = getenv("XAPIAN_MMAP_READONLY");
+    if (!p || atoi(p) == 0) return;
+
+    struct stat statbuf;
+    if (fstat(handle, &statbuf) < 0 || statbuf.st_size <= 0) return;
+    // Don't try to map a file too large to be addressed (only an issue on
+    // platforms with a 32-bit address space).
+    if (off_t(size_t(statbuf.st_size)) != statbuf.st_size) return;
+
+    size_t len = size_t(statbuf.st_size);
+    void * addr = mmap(NULL, len, PROT_READ, MAP_SHARED, handle, 0);
+    // If we can't map the file, just read it in the usual way.
+    if (addr == MAP_FAILED) return;
+    map_addr = static_cast<const byte *>(addr);
+    map_size = len;
+#endif
+}
+
 void
 BrassTable::open()
 {
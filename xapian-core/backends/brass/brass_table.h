@@ -377,6 +377,9 @@ class BrassTable {
 	 *
 	 *  This must be called before commit, to ensure that the DB file is
 	 *  ready to be switched to a new version by the commit.
+	 *
+	 *  Writing the changed blocks to disk is started, but not waited for -
+	 *  that happens in commit().
 	 */
 	void flush_db();
 
@@ -428,6 +431,27 @@ class BrassTable {
 	 */
 	bool get_exact_entry(const std::string & key, std::string & tag) const;
 
+	/** Read the start of the tag for a given key.
+	 *
+	 *  This is just like get_exact_entry() except that if the tag is
+	 *  split across several items, only as many items as are needed to
+	 *  give at least @a min_len bytes are read.  This is more efficient if
+	 *  you only want to decode a header at the start of the tag.  The first
+	 *  item can hold very little of a tag, so @a min_len needs to be the
+	 *  longest the header can be.  A compressed tag is always read in full.
+	 *
+	 *  @param key  The key to look for in the table.
+	 *  @param tag  A tag object to fill with the start of the value if
+	 *		found.
+	 *  @param min_len  The number of bytes wanted from the start of the
+	 *		    tag (fewer are returned if the tag is shorter).
+	 *
+	 *  @return true if key is found in table,
+	 *          false if key is not found in table.
+	 */
+	bool get_exact_entry_start(const std::string & key,
+				   std::string & tag, size_t min_len) const;
+
 	/** Check if a key exists in the Btree.
 	 *
 	 *  This is just like get_exact_entry() except it doesn't read the tag
@@ -606,6 +630,12 @@ class BrassTable {
 	 */
 	bool do_open_to_read(bool revision_supplied, brass_revision_number_t revision_);
 
+	/** Map the table's file into memory if requested.
+	 *
+	 *  Only used for tables opened read-only.
+	 */
+	void map_table();
+
 	/** Perform the opening operation to write.
 	 *
 	 *  Return true iff the open succeeded.
@@ -684,6 +714,18 @@ class BrassTable {
 	 */
 	int handle;
 
+	/** Address the table's file is mapped at, or NULL if it isn't mapped.
+	 *
+	 *  Tables are only ever mapped when opened read-only and the
+	 *  environment variable XAPIAN_MMAP_READONLY is set to a non-zero
+	 *  value.  read_block() can then copy blocks from the mapping rather
+	 *  than making a system call for each block.
+	 */
+	const byte * map_addr;
+
+	/// The length of the mapping at map_addr (if map_addr isn't NULL).
+	size_t map_size;
+
 	/// number of levels, counting from 0
 	int level;
 
@@ -771,6 +813,10 @@ class BrassTable {
 	 *  Z_RLE. */
 	int compress_strategy;
 
+	/** Only store a tag compressed if that saves at least
+	 *  1/compress_min_saving of its size. */
+	size_t compress_min_saving;
+
 	CompressionStream comp_stream;
 
 	/// If true, don't create the table until it's needed.
@@ -41,23 +41,25 @@
 using namespace std;
 
 // YYYYMMDDX where X allows multiple format revisions in a day
-#define BRASS_VERSION 201103110
+#define BRASS_VERSION 202610191
+// 202610191 1.3.0 Add flags to the version file (for edge n-grams)
+// 202610190 1.3.0 Store a wdf upper bound for each term in postlist
 // 201103110 1.2.5 Bump for new max changesets dbstats
 // 200912150 1.1.4 Brass debuts.
 
 #define MAGIC_STRING "IAmBrass"
 
 #define MAGIC_LEN CONST_STRLEN(MAGIC_STRING)
-// 4 for the version number; 16 for the UUID.
-#define VERSIONFILE_SIZE (MAGIC_LEN + 4 + 16)
+// 4 for the version number; 16 for the UUID; 1 for the flags.
+#define VERSIONFILE_SIZE (MAGIC_LEN + 4 + 16 + 1)
 
 // Literal version of VERSIONFILE_SIZE, used for error message.  This needs
 // to be updated by hand should VERSIONFILE_SIZE change, but that rarely
 // happens so this isn't an onerous requirement.
-#define VERSIONFILE_SIZE_LITERAL 28
+#define VERSIONFILE_SIZE_LITERAL 29
 
 void
-BrassVersion::create()
+BrassVersion::create(unsigned char flags_)
 {
     char buf[VERSIONFILE_SIZE] = MAGIC_STRING;
     unsigned char *v = reinterpret_cast<unsigned char *>(buf) + MAGIC_LEN;
@@ -68,6 +70,8 @@ BrassVersion::create()
 
     uuid_generate(uuid);
     memcpy(buf + MAGIC_LEN + 4, (void*)uuid, 16);
+    flags = flags_;
+    buf[MAGIC_LEN + 4 + 16] = char(flags);
 
     int fd = ::open(filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC|O_BINARY|O_CLOEXEC, 0666);
 
@@ -140,4 +144,11 @@ BrassVersion::read_and_check()
     }
 
     memcpy((void*)uuid, buf + MAGIC_LEN + 4, 16);
+    flags = static_cast<unsigned char>(buf[MAGIC_LEN + 4 + 16]);
+    if (flags & ~FLAG_EDGE_NGRAMS) {
+	string msg = filename;
+	msg += ": Brass version file has flags I don't understand: ";
+	msg += str(int(flags));
+	throw Xapian::DatabaseVersionError(msg);
+    }
 }
@@ -29,7 +29,8 @@
 /** The BrassVersion class manages the "iambrass" file.
  *
  *  The "iambrass" file (currently) contains a "magic" string identifying
- *  that this is a brass database and a database format version number.
+ *  that this is a brass database, a database format version number, the
+ *  UUID, and flags for options chosen when the database was created.
  */
 class BrassVersion {
     /// The filename of the version file.
@@ -41,13 +42,22 @@ class BrassVersion {
      */
     mutable uuid_t uuid;
 
+    /// Bitwise-OR of FLAG_* values.
+    unsigned char flags;
+
   public:
-    BrassVersion(const std::string & dbdir) : filename(dbdir) {
+    /// Edge n-gram terms aren't counted in document lengths.
+    static const unsigned char FLAG_EDGE_NGRAMS = 1;
+
+    BrassVersion(const std::string & dbdir) : filename(dbdir), flags(0) {
 	filename += "/iambrass";
     }
 
-    /** Create the version file. */
-    void create();
+    /** Create the version file.
+     *
+     *  @param flags_	Bitwise-OR of FLAG_* values to store.
+     */
+    void create(unsigned char flags_ = 0);
 
     /** Read the version file and check it's a version we understand.
      *
@@ -55,6 +65,9 @@ class BrassVersion {
      */
     void read_and_check();
 
+    /// Return the flags stored when the database was created.
+    unsigned char get_flags() const { return flags; }
+
     /// Return pointer to 16 byte UUID.
     const char * get_uuid() const {
 	// uuid is unsigned char[].
@@ -117,6 +117,10 @@ ChertDatabase::ChertDatabase(const string &chert_dir, int action,
 {
     LOGCALL_CTOR(DB, "ChertDatabase", chert_dir | action | block_size);
 
+    // Chert doesn't support a permuterm index, and always counts edge
+    // n-grams in document lengths.
+    action &= ~(Xapian::DB_PERMUTERM | Xapian::DB_EDGE_NGRAMS);
+
     if (action == XAPIAN_DB_READONLY) {
 	open_tables_consistent();
 	return;
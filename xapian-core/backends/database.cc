@@ -30,6 +30,7 @@
 #include "api/leafpostlist.h"
 #include "omassert.h"
 #include "slowvaluelist.h"
+#include "wildcardtermlist.h"
 
 #include <algorithm>
 #include <string>
@@ -233,6 +234,13 @@ Database::Internal::open_spelling_termlist(const string &) const
     return NULL;
 }
 
+TermList *
+Database::Internal::open_wildcard_terms(const string & pattern) const
+{
+    string prefix(pattern, 0, pattern.find('*'));
+    return new WildcardTermList(open_allterms(prefix), pattern);
+}
+
 TermList *
 Database::Internal::open_spelling_wordlist() const
 {
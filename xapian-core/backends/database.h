@@ -264,6 +264,21 @@ class Database::Internal : public Xapian::Internal::intrusive_base {
 	 */
 	virtual TermList * open_allterms(const string & prefix) const = 0;
 
+	/** Open a list of the terms matching a wildcard pattern.
+	 *
+	 *  Each '*' in @a pattern matches any sequence of characters.  The
+	 *  default implementation filters open_allterms() for the literal
+	 *  prefix of @a pattern (i.e. everything before the first '*'), so a
+	 *  pattern starting with '*' has to look at every term.  Backends
+	 *  which keep an index of rotated terms override this.
+	 *
+	 *  @param pattern The pattern to match.
+	 *  @return        A pointer to the newly created term list, which
+	 *                 returns the matching terms in sorted order.  This
+	 *                 object must be deleted by the caller after use.
+	 */
+	virtual TermList * open_wildcard_terms(const string & pattern) const;
+
 	/** Open a position list for the given term in the given document.
 	 *
 	 *  @param did    The document id for which a position list is being
@@ -171,7 +171,7 @@ Database::check(const string & path, int opts, std::ostream &out)
 	// that we can cross-check the document lengths.
 	const char * tables[] = {
 	    "record", "termlist", "postlist", "position",
-	    "spelling", "synonym"
+	    "spelling", "synonym", "permuterm"
 	};
 	for (const char **t = tables;
 	     t != tables + sizeof(tables)/sizeof(tables[0]); ++t) {
@@ -182,7 +182,8 @@ Database::check(const string & path, int opts, std::ostream &out)
 	    if (strcmp(*t, "record") != 0 && strcmp(*t, "postlist") != 0) {
 		// Other tables are created lazily, so may not exist.
 		if (!file_exists(table + ".DB")) {
-		    if (strcmp(*t, "termlist") == 0) {
+		    if (strcmp(*t, "termlist") == 0 ||
+			strcmp(*t, "permuterm") == 0) {
 			out << "Not present.\n";
 		    } else {
 			out << "Lazily created, and not yet used.\n";
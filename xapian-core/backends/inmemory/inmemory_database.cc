@@ -46,6 +46,13 @@ using Xapian::Internal::intrusive_ptr;
 inline void
 InMemoryTerm::add_posting(const InMemoryPosting & post)
 {
+    // Documents are usually added in ascending docid order, so check if we
+    // can just append first.
+    if (docs.empty() || docs.back().did < post.did) {
+	docs.push_back(post);
+	return;
+    }
+
     // Add document to right place in list
     vector<InMemoryPosting>::iterator p;
     p = lower_bound(docs.begin(), docs.end(),
@@ -59,17 +66,48 @@ InMemoryTerm::add_posting(const InMemoryPosting & post)
     }
 }
 
+const InMemoryPosting *
+InMemoryTerm::find_posting(Xapian::docid did) const
+{
+    InMemoryPosting key;
+    key.did = did;
+    vector<InMemoryPosting>::const_iterator p;
+    p = lower_bound(docs.begin(), docs.end(), key, InMemoryPostingLessThan());
+    if (p == docs.end() || p->did != did) return NULL;
+    return &*p;
+}
+
+void
+InMemoryTerm::invalidate_posting(Xapian::docid did)
+{
+    InMemoryPosting key;
+    key.did = did;
+    vector<InMemoryPosting>::iterator p;
+    p = lower_bound(docs.begin(), docs.end(), key, InMemoryPostingLessThan());
+    // Just invalidate erased doc ids - otherwise we need to erase in a vector
+    // (inefficient) and we break any posting lists iterating over this
+    // posting list.
+    if (p != docs.end() && p->did == did) p->valid = false;
+}
+
 inline void
 InMemoryDoc::add_posting(const InMemoryTermEntry & post)
 {
-    // Add document to right place in list
+    // Terms are usually added in sorted order, so check if we can just
+    // append first.
+    if (terms.empty() || terms.back().tname < post.tname) {
+	terms.push_back(post);
+	return;
+    }
+
+    // Add term to right place in list
     vector<InMemoryTermEntry>::iterator p;
     p = lower_bound(terms.begin(), terms.end(),
 		    post, InMemoryTermEntryLessThan());
     if (p == terms.end() || InMemoryTermEntryLessThan()(post, *p)) {
 	terms.insert(p, post);
     } else {
-	(*p).merge(post);
+	p->wdf += post.wdf;
     }
 }
 
@@ -120,20 +158,38 @@ InMemoryPostList::next(double /*w_min*/)
 }
 
 PostList *
-InMemoryPostList::skip_to(Xapian::docid did, double w_min)
+InMemoryPostList::skip_to(Xapian::docid did, double /*w_min*/)
 {
     if (db->is_closed()) InMemoryDatabase::throw_database_closed();
-    // FIXME - see if we can make more efficient, perhaps using better
-    // data structure.  Note, though, that a binary search of
-    // the remaining list may NOT be a good idea (search time is then
-    // O(log {length of list}), as opposed to O(distance we want to skip)
-    // Since we will frequently only be skipping a short distance, this
-    // could well be worse.
-    started = true;
-    Assert(!at_end());
-    while (!at_end() && (*pos).did < did) {
-	(void) next(w_min);
+    // A binary search of the whole of the remaining list isn't a good idea
+    // as we'll often only be skipping a short distance, so we gallop forward
+    // in steps which double in size until we pass the target, then binary
+    // search the final step.  This is O(log {distance we want to skip}).
+    if (!started) {
+	started = true;
+    } else {
+	Assert(!at_end());
+    }
+    if (pos == end || pos->did >= did) return NULL;
+
+    InMemoryPosting key;
+    key.did = did;
+    vector<InMemoryPosting>::const_iterator lo = pos;
+    vector<InMemoryPosting>::difference_type step = 1;
+    while (true) {
+	if (end - lo <= step) {
+	    pos = lower_bound(lo, end, key, InMemoryPostingLessThan());
+	    break;
+	}
+	vector<InMemoryPosting>::const_iterator hi = lo + step;
+	if (hi->did >= did) {
+	    pos = lower_bound(lo, hi, key, InMemoryPostingLessThan());
+	    break;
+	}
+	lo = hi;
+	step *= 2;
     }
+    while (pos != end && !pos->valid) ++pos;
     return NULL;
 }
 
@@ -226,8 +282,7 @@ InMemoryTermList::accumulate_stats(Xapian::Internal::ExpandStats & stats) const
     if (db->is_closed()) InMemoryDatabase::throw_database_closed();
     Assert(started);
     Assert(!at_end());
-    stats.accumulate(InMemoryTermList::get_wdf(), document_length,
-		     InMemoryTermList::get_termfreq(),
+    stats.accumulate(InMemoryTermList::get_wdf(), document_length, *this,
 		     db->get_doccount());
 }
 
@@ -595,15 +650,9 @@ InMemoryDatabase::positionlist_count(Xapian::docid did,
     if (!doc_exists(did)) {
 	return 0;
     }
-    const InMemoryDoc &doc = termlists[did-1];
-
-    vector<InMemoryTermEntry>::const_iterator i;
-    for (i = doc.terms.begin(); i != doc.terms.end(); ++i) {
-	if (i->tname == tname) {
-	    return i->positions.size();
-	}
-    }
-    return 0;
+    const InMemoryPosting * posting = find_posting(did, tname);
+    if (!posting) return 0;
+    return posting->positions.size();
 }
 
 PositionList * 
@@ -612,18 +661,30 @@ InMemoryDatabase::open_position_list(Xapian::docid did,
 {
     if (closed) InMemoryDatabase::throw_database_closed();
     if (usual(doc_exists(did))) {
-	const InMemoryDoc &doc = termlists[did-1];
-
-	vector<InMemoryTermEntry>::const_iterator i;
-	for (i = doc.terms.begin(); i != doc.terms.end(); ++i) {
-	    if (i->tname == tname) {
-		return new InMemoryPositionList(i->positions);
-	    }
-	}
+	const InMemoryPosting * posting = find_posting(did, tname);
+	if (posting) return new InMemoryPositionList(posting->positions);
     }
     return new InMemoryPositionList(false);
 }
 
+const InMemoryPosting *
+InMemoryDatabase::find_posting(Xapian::docid did, const string & tname) const
+{
+    // Check the term is in the document's termlist first.  The posting
+    // itself may be invalid if we're part way through replacing the document
+    // with itself, which is OK as it can't have been overwritten yet.
+    const vector<InMemoryTermEntry> & terms = termlists[did - 1].terms;
+    InMemoryTermEntry key;
+    key.tname = tname;
+    if (!binary_search(terms.begin(), terms.end(), key,
+		       InMemoryTermEntryLessThan()))
+	return NULL;
+
+    map<string, InMemoryTerm>::const_iterator t = postlists.find(tname);
+    if (t == postlists.end()) return NULL;
+    return t->second.find_posting(did);
+}
+
 void
 InMemoryDatabase::add_values(Xapian::docid did,
 			     const map<Xapian::valueno, string> &values_)
@@ -698,6 +759,13 @@ InMemoryDatabase::delete_document(Xapian::docid did)
     // InMemory structure without being very inefficient.
     if (totdocs == 0) positions_present = false;
 
+    remove_postings(did);
+    termlists[did-1].terms.clear();
+}
+
+void
+InMemoryDatabase::remove_postings(Xapian::docid did)
+{
     vector<InMemoryTermEntry>::const_iterator i;
     for (i = termlists[did - 1].terms.begin();
 	 i != termlists[did - 1].terms.end();
@@ -706,16 +774,8 @@ InMemoryDatabase::delete_document(Xapian::docid did)
 	Assert(t != postlists.end());
 	t->second.collection_freq -= i->wdf;
 	--t->second.term_freq;
-	vector<InMemoryPosting>::iterator posting = t->second.docs.begin();
-	while (posting != t->second.docs.end()) {
-	    // Just zero out erased doc ids - otherwise we need to erase
-	    // in a vector (inefficient) and we break any posting lists
-	    // iterating over this posting list.
-	    if (posting->did == did) posting->valid = false;
-	    ++posting;
-	}
+	t->second.invalidate_posting(did);
     }
-    termlists[did-1].terms.clear();
 }
 
 void
@@ -749,23 +809,7 @@ InMemoryDatabase::replace_document(Xapian::docid did,
 	termlists[did - 1].is_valid = true;
     }
 
-    vector<InMemoryTermEntry>::const_iterator i;
-    for (i = termlists[did - 1].terms.begin();
-	 i != termlists[did - 1].terms.end();
-	 ++i) {
-	map<string, InMemoryTerm>::iterator t = postlists.find(i->tname);
-	Assert(t != postlists.end());
-	t->second.collection_freq -= i->wdf;
-	--t->second.term_freq;
-	vector<InMemoryPosting>::iterator posting = t->second.docs.begin();
-	while (posting != t->second.docs.end()) {
-	    // Just invalidate erased doc ids - otherwise we need to erase
-	    // in a vector (inefficient) and we break any posting lists
-	    // iterating over this posting list.
-	    if (posting->did == did) posting->valid = false;
-	    ++posting;
-	}
-    }
+    remove_postings(did);
 
     doclengths[did - 1] = 0;
     doclists[did - 1] = document.get_data();
@@ -801,39 +845,44 @@ InMemoryDatabase::finish_add_doc(Xapian::docid did, const Xapian::Document &docu
     }
 
     InMemoryDoc doc(true);
+    doc.terms.reserve(document.termlist_count());
     Xapian::TermIterator i = document.termlist_begin();
     for ( ; i != document.termlist_end(); ++i) {
-	make_term(*i);
-
 	LOGLINE(DB, "InMemoryDatabase::finish_add_doc(): adding term " << *i);
+	InMemoryTerm & term = postlists[*i];
+	Xapian::termcount wdf = i.get_wdf();
+
+	// Make the posting.  The positions from the PositionIterator are
+	// already sorted, so we can just copy them in one go.
+	InMemoryPosting posting;
+	posting.did = did;
+	posting.valid = true;
+	posting.wdf = wdf;
 	Xapian::PositionIterator j = i.positionlist_begin();
-	if (j == i.positionlist_end()) {
-	    /* Make sure the posting exists, even without a position. */
-	    make_posting(&doc, *i, did, 0, i.get_wdf(), false);
-	} else {
+	if (j != i.positionlist_end()) {
 	    positions_present = true;
-	    for ( ; j != i.positionlist_end(); ++j) {
-		make_posting(&doc, *i, did, *j, i.get_wdf());
-	    }
+	    posting.positions.reserve(i.positionlist_count());
+	    posting.positions.assign(j, i.positionlist_end());
 	}
+	term.add_posting(posting);
+
+	// Make the termentry.
+	InMemoryTermEntry termentry;
+	termentry.tname = *i;
+	termentry.wdf = wdf;
+	doc.add_posting(termentry);
 
 	Assert(did > 0 && did <= doclengths.size());
-	doclengths[did - 1] += i.get_wdf();
-	totlen += i.get_wdf();
-	postlists[*i].collection_freq += i.get_wdf();
-	++postlists[*i].term_freq;
+	doclengths[did - 1] += wdf;
+	totlen += wdf;
+	term.collection_freq += wdf;
+	++term.term_freq;
     }
     swap(termlists[did - 1], doc);
 
     totdocs++;
 }
 
-void
-InMemoryDatabase::make_term(const string & tname)
-{
-    postlists[tname];  // Initialise, if not already there.
-}
-
 Xapian::docid
 InMemoryDatabase::make_doc(const string & docdata)
 {
@@ -846,43 +895,6 @@ InMemoryDatabase::make_doc(const string & docdata)
     return termlists.size();
 }
 
-void InMemoryDatabase::make_posting(InMemoryDoc * doc,
-				    const string & tname,
-				    Xapian::docid did,
-				    Xapian::termpos position,
-				    Xapian::termcount wdf,
-				    bool use_position)
-{
-    Assert(doc);
-    Assert(postlists.find(tname) != postlists.end());
-    Assert(did > 0 && did <= termlists.size());
-    Assert(did > 0 && did <= doclengths.size());
-    Assert(doc_exists(did));
-
-    // Make the posting
-    InMemoryPosting posting;
-    posting.did = did;
-    if (use_position) {
-	posting.positions.push_back(position);
-    }
-    posting.wdf = wdf;
-    posting.valid = true;
-
-    // Now record the posting
-    postlists[tname].add_posting(posting);
-
-    // Make the termentry
-    InMemoryTermEntry termentry;
-    termentry.tname = tname;
-    if (use_position) {
-	termentry.positions.push_back(position);
-    }
-    termentry.wdf = wdf;
-
-    // Now record the termentry
-    doc->add_posting(termentry);
-}
-
 bool
 InMemoryDatabase::term_exists(const string & tname) const
 {
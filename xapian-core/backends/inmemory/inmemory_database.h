@@ -62,22 +62,12 @@ class InMemoryPosting {
 	}
 };
 
+// Class representing a term in a document's termlist.  The positional
+// information is only stored in the corresponding InMemoryPosting.
 class InMemoryTermEntry {
     public:
 	string tname;
-	vector<Xapian::termpos> positions; // Sorted vector of positions
 	Xapian::termcount wdf;
-
-	// Merge two postings (same term/doc pair, new positional info)
-	void merge(const InMemoryTermEntry & post) {
-	    Assert(tname == post.tname);
-
-	    positions.insert(positions.end(),
-			     post.positions.begin(),
-			     post.positions.end());
-	    // FIXME - inefficient - use merge (and list<>)?
-	    sort(positions.begin(), positions.end());
-	}
 };
 
 // Compare by document ID
@@ -110,6 +100,15 @@ class InMemoryTerm {
 	InMemoryTerm() : term_freq(0), collection_freq(0) {}
 
 	void add_posting(const InMemoryPosting & post);
+
+	/** Find the posting for document @a did, or return NULL if none.
+	 *
+	 *  The posting returned may have been marked as invalid.
+	 */
+	const InMemoryPosting * find_posting(Xapian::docid did) const;
+
+	/// Mark the posting for document @a did as invalid, if there is one.
+	void invalidate_posting(Xapian::docid did);
 };
 
 /// Class representing a document and the terms indexing it.
@@ -264,21 +263,19 @@ class InMemoryDatabase : public Xapian::Database::Internal {
     InMemoryDatabase& operator=(const InMemoryDatabase &);
     InMemoryDatabase(const InMemoryDatabase &);
 
-    void make_term(const string & tname);
-
     bool doc_exists(Xapian::docid did) const;
     Xapian::docid make_doc(const string & docdata);
 
     /* The common parts of add_doc and replace_doc */
     void finish_add_doc(Xapian::docid did, const Xapian::Document &document);
-    void add_values(Xapian::docid did, const map<Xapian::valueno, string> &values_);
 
-    void make_posting(InMemoryDoc * doc,
-		      const string & tname,
-		      Xapian::docid did,
-		      Xapian::termpos position,
-		      Xapian::termcount wdf,
-		      bool use_position = true);
+    /// Remove the postings for the terms in document @a did's termlist.
+    void remove_postings(Xapian::docid did);
+
+    /// Find the posting for term @a tname in document @a did, or NULL.
+    const InMemoryPosting * find_posting(Xapian::docid did,
+					 const string & tname) const;
+    void add_values(Xapian::docid did, const map<Xapian::valueno, string> &values_);
 
     //@{
     /** Implementation of virtual methods: see Database for details.
@@ -26,10 +26,34 @@
 #include "debuglog.h"
 #include "omassert.h"
 
+#include <algorithm>
+
 #ifdef XAPIAN_ASSERTIONS_PARANOID
 #include "xapian/database.h"
 #endif
 
+/** Comparison functor which orders sub-postlists by ascending merged docid.
+ *
+ *  Used with the STL heap algorithms, so it compares "greater than" to put the
+ *  lowest merged docid at the top of the heap.  The order of merged docids is
+ *  the same as the order of (sub-database docid, sub-database index), so we
+ *  don't need to calculate the merged docids.
+ */
+class CompareSubPostLists {
+    const std::vector<LeafPostList *> & postlists;
+
+  public:
+    explicit CompareSubPostLists(const std::vector<LeafPostList *> & pls)
+	: postlists(pls) { }
+
+    bool operator()(Xapian::doccount a, Xapian::doccount b) const {
+	Xapian::docid did_a = postlists[a]->get_docid();
+	Xapian::docid did_b = postlists[b]->get_docid();
+	if (did_a != did_b) return did_a > did_b;
+	return a > b;
+    }
+};
+
 MultiPostList::MultiPostList(std::vector<LeafPostList *> & pls,
 			     const Xapian::Database &this_db_)
 	: postlists(pls),
@@ -38,6 +62,12 @@ MultiPostList::MultiPostList(std::vector<LeafPostList *> & pls,
 	  currdoc(0)
 {
     multiplier = pls.size();
+    // Our caller has already called next() on each sub-postlist.
+    heap.reserve(multiplier);
+    for (Xapian::doccount i = 0; i != multiplier; ++i) {
+	if (!postlists[i]->at_end()) heap.push_back(i);
+    }
+    make_heap(heap.begin(), heap.end(), CompareSubPostLists(postlists));
 }
 
 
@@ -105,7 +135,7 @@ MultiPostList::get_doclength() const
     LOGCALL(DB, Xapian::termcount, "MultiPostList::get_doclength", NO_ARGS);
     Assert(!at_end());
     Assert(currdoc != 0);
-    Xapian::termcount result = postlists[(currdoc - 1) % multiplier]->get_doclength();
+    Xapian::termcount result = postlists[heap.front()]->get_doclength();
     AssertEqParanoid(result, this_db.get_doclength(get_docid()));
     RETURN(result);
 }
@@ -113,13 +143,15 @@ MultiPostList::get_doclength() const
 Xapian::termcount
 MultiPostList::get_wdf() const
 {
-    return postlists[(currdoc - 1) % multiplier]->get_wdf();
+    Assert(!at_end());
+    return postlists[heap.front()]->get_wdf();
 }
 
 PositionList *
 MultiPostList::open_position_list() const
 {
-    return postlists[(currdoc - 1) % multiplier]->open_position_list();
+    Assert(!at_end());
+    return postlists[heap.front()]->open_position_list();
 }
 
 PostList *
@@ -128,34 +160,20 @@ MultiPostList::next(double w_min)
     LOGCALL(DB, PostList *, "MultiPostList::next", w_min);
     Assert(!at_end());
 
-    Xapian::docid newdoc = 0;
-    Xapian::docid offset = 1;
-    std::vector<LeafPostList *>::iterator i;
-    for (i = postlists.begin(); i != postlists.end(); i++) {
-	if (!(*i)->at_end()) {
-	    Xapian::docid id = ((*i)->get_docid() - 1) * multiplier + offset;
-	    // Check if it needs to be advanced
-	    if (currdoc >= id) {
-		(*i)->next(w_min);
-		if (!(*i)->at_end()) {
-		    id = ((*i)->get_docid() - 1) * multiplier + offset;
-		    if (newdoc == 0 || id < newdoc) newdoc = id;
-		}
-	    } else {
-		if (newdoc == 0 || id < newdoc) newdoc = id;
-	    }
+    // The sub-postlists start on their first entries, so the first call just
+    // needs to look at the top of the heap.
+    if (currdoc != 0) {
+	CompareSubPostLists cmp(postlists);
+	pop_heap(heap.begin(), heap.end(), cmp);
+	LeafPostList * pl = postlists[heap.back()];
+	pl->next(w_min);
+	if (pl->at_end()) {
+	    heap.pop_back();
+	} else {
+	    push_heap(heap.begin(), heap.end(), cmp);
 	}
-	offset++;
-    }
-    if (newdoc) {
-	LOGLINE(DB, "MultiPostList::next() newdoc=" << newdoc <<
-		    " (olddoc=" << currdoc << ")");
-	currdoc = newdoc;
-    } else {
-	LOGLINE(DB, "MultiPostList::next() finished" <<
-		    " (olddoc=" << currdoc << ")");
-	finished = true;
     }
+    update_currdoc();
     RETURN(NULL);
 }
 
@@ -164,30 +182,42 @@ MultiPostList::skip_to(Xapian::docid did, double w_min)
 {
     LOGCALL(DB, PostList *, "MultiPostList::skip_to", did | w_min);
     Assert(!at_end());
-    Xapian::docid newdoc = 0;
-    Xapian::docid offset = 0;
-    Xapian::docid realdid = (did - 1) / multiplier + 2;
+    // The docid in sub-database dbnumber which did maps to.  Sub-databases
+    // before that one need to skip to the next docid after this, and those
+    // after it to this docid.
+    Xapian::docid realdid = (did - 1) / multiplier + 1;
     Xapian::doccount dbnumber = (did - 1) % multiplier;
-    std::vector<LeafPostList *>::iterator i;
-    for (i = postlists.begin(); i != postlists.end(); ++i) {
-	if (offset == dbnumber) --realdid;
-	++offset;
-	Assert((realdid - 1) * multiplier + offset >= did);
-	Assert((realdid - 1) * multiplier + offset < did + multiplier);
-	if (!(*i)->at_end()) {
-	    (*i)->skip_to(realdid, w_min);
-	    if (!(*i)->at_end()) {
-		Xapian::docid id = ((*i)->get_docid() - 1) * multiplier + offset;
-		if (newdoc == 0 || id < newdoc) newdoc = id;
-	    }
+    CompareSubPostLists cmp(postlists);
+    // Only the sub-postlists currently before did need to move, and those are
+    // at the top of the heap.
+    while (!heap.empty()) {
+	Xapian::doccount idx = heap.front();
+	Xapian::docid target = realdid + (idx < dbnumber);
+	LeafPostList * pl = postlists[idx];
+	if (pl->get_docid() >= target) break;
+	pop_heap(heap.begin(), heap.end(), cmp);
+	pl->skip_to(target, w_min);
+	if (pl->at_end()) {
+	    heap.pop_back();
+	} else {
+	    push_heap(heap.begin(), heap.end(), cmp);
 	}
     }
-    if (newdoc) {
-	currdoc = newdoc;
-    } else {
+    update_currdoc();
+    RETURN(NULL);
+}
+
+void
+MultiPostList::update_currdoc()
+{
+    if (heap.empty()) {
+	LOGLINE(DB, "MultiPostList finished (olddoc=" << currdoc << ")");
 	finished = true;
+	return;
     }
-    RETURN(NULL);
+    Xapian::doccount idx = heap.front();
+    currdoc = (postlists[idx]->get_docid() - 1) * multiplier + idx + 1;
+    LOGLINE(DB, "MultiPostList currdoc=" << currdoc);
 }
 
 bool
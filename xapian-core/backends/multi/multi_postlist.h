@@ -31,6 +31,14 @@ class MultiPostList : public PostList {
     private:
 	std::vector<LeafPostList *> postlists;
 
+	/** Indices into postlists of those not yet at_end(), as a heap.
+	 *
+	 *  The one with the lowest merged docid is at the top, so next() and
+	 *  skip_to() only need to look at the sub-postlists they advance,
+	 *  rather than every one.
+	 */
+	std::vector<Xapian::doccount> heap;
+
 	const Xapian::Database &this_db;
 
 	bool   finished;
@@ -40,6 +48,9 @@ class MultiPostList : public PostList {
 
 	MultiPostList(std::vector<LeafPostList *> & pls,
 		      const Xapian::Database &this_db_);
+
+	/// Set currdoc from the top of the heap, or finished if it's empty.
+	void update_currdoc();
     public:
 	~MultiPostList();
 
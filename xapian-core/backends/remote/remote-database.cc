@@ -59,12 +59,14 @@ throw_bad_message(const string & context)
 }
 
 RemoteDatabase::RemoteDatabase(int fd, double timeout_,
-			       const string & context_, bool writable)
+			       const string & context_, bool writable,
+			       bool compress)
 	: link(fd, fd, context_),
 	  context(context_),
 	  cached_stats_valid(),
 	  mru_valstats(),
 	  mru_slot(Xapian::BAD_VALUENO),
+	  cache_query_stats(!writable),
 	  timeout(timeout_)
 {
 #ifndef __WIN32__
@@ -86,6 +88,13 @@ RemoteDatabase::RemoteDatabase(int fd, double timeout_,
 
     update_stats(MSG_MAX);
 
+    if (compress) {
+	// The server's protocol version is at least ours, so it understands
+	// compressed messages.  This message doesn't get a reply.
+	link.enable_compression();
+	send_message(MSG_COMPRESSION, string());
+    }
+
     if (writable) update_stats(MSG_WRITEACCESS);
 }
 
@@ -350,6 +359,8 @@ RemoteDatabase::update_stats(message_type msg_code) const
     total_length = decode_length(&p, p_end, false);
     uuid.assign(p, p_end);
     cached_stats_valid = true;
+    // The database may have changed, so the query stats may have too.
+    query_stats_cache.clear();
     return true;
 }
 
@@ -561,6 +572,8 @@ RemoteDatabase::set_query(const Xapian::Query& query,
     string tmp = query.serialise();
     string message = encode_length(tmp.size());
     message += tmp;
+    // The remote stats only depend on the query and the rset.
+    if (cache_query_stats) query_stats_key = message;
 
     // Serialise assorted Enquire settings.
     message += encode_length(qlen);
@@ -584,6 +597,7 @@ RemoteDatabase::set_query(const Xapian::Query& query,
     tmp = serialise_rset(omrset);
     message += encode_length(tmp.size());
     message += tmp;
+    if (cache_query_stats) query_stats_key += tmp;
 
     vector<Xapian::MatchSpy *>::const_iterator i;
     for (i = matchspies.begin(); i != matchspies.end(); ++i) {
@@ -599,18 +613,37 @@ RemoteDatabase::set_query(const Xapian::Query& query,
 	message += tmp;
     }
 
+    pending_query.resize(0);
+    if (cache_query_stats && query_stats_cache.find(query_stats_key)) {
+	// We already have the stats, so send the query along with the global
+	// stats to save a round trip.
+	swap(pending_query, message);
+	return;
+    }
+
     send_message(MSG_QUERY, message);
 }
 
 bool
 RemoteDatabase::get_remote_stats(bool nowait, Xapian::Weight::Internal &out)
 {
+    if (!pending_query.empty()) {
+	// set_query() only sets pending_query if the stats are cached.
+	const Xapian::Weight::Internal * stats =
+	    query_stats_cache.find(query_stats_key);
+	Assert(stats);
+	out = *stats;
+	return true;
+    }
+
     if (nowait && !link.ready_to_read()) return false;
 
     string message;
     get_message(message, REPLY_STATS);
     out = unserialise_stats(message);
 
+    if (cache_query_stats) query_stats_cache.insert(query_stats_key) = out;
+
     return true;
 }
 
@@ -624,9 +657,28 @@ RemoteDatabase::send_global_stats(Xapian::doccount first,
     message += encode_length(maxitems);
     message += encode_length(check_at_least);
     message += serialise_stats(stats);
+    if (!pending_query.empty()) {
+	string query_message = encode_length(pending_query.size());
+	query_message += pending_query;
+	query_message += message;
+	pending_query.resize(0);
+	send_message(MSG_QUERYMSET, query_message);
+	return;
+    }
     send_message(MSG_GETMSET, message);
 }
 
+void
+RemoteDatabase::send_get_more(Xapian::doccount first,
+			      Xapian::doccount maxitems,
+			      double w_min)
+{
+    string message = encode_length(first);
+    message += encode_length(maxitems);
+    message += serialise_double(w_min);
+    send_message(MSG_GETMORE, message);
+}
+
 void
 RemoteDatabase::get_mset(Xapian::MSet &mset,
 			 const vector<Xapian::MatchSpy *> & matchspies)
@@ -27,8 +27,11 @@
 #include "api/queryinternal.h"
 #include "net/remoteconnection.h"
 #include "backends/valuestats.h"
+#include "weight/weightinternal.h"
 #include "xapian/weight.h"
 
+#include "boundedcache.h"
+
 namespace Xapian {
     class RSet;
 }
@@ -86,6 +89,36 @@ class RemoteDatabase : public Xapian::Database::Internal {
      */
     mutable Xapian::valueno mru_slot;
 
+    /** Should we cache the remote stats for queries?
+     *
+     *  A writable database's stats change as documents are modified, so we
+     *  only cache them for a read-only database.
+     */
+    bool cache_query_stats;
+
+    /** The remote stats for recent queries, keyed by query_stats_key.
+     *
+     *  These remain valid until the server sends a REPLY_UPDATE after a
+     *  reopen(), which we only get if the database has changed.
+     *
+     *  Each entry holds statistics for every term in its query, so can be
+     *  much larger than a term's, but the case this helps with is a small
+     *  set of queries run repeatedly (e.g. fetching further pages of
+     *  results), so we only keep 100.
+     */
+    mutable BoundedCache<string, Xapian::Weight::Internal, 100> query_stats_cache;
+
+    /// The query_stats_cache key for the query passed to set_query().
+    string query_stats_key;
+
+    /** The MSG_QUERY message for the current query if we had its stats.
+     *
+     *  In this case, set_query() doesn't send anything, and instead
+     *  send_global_stats() sends this with the global stats as a single
+     *  MSG_QUERYMSET message.  Otherwise this is empty.
+     */
+    string pending_query;
+
     bool update_stats(message_type msg_code = MSG_UPDATE) const;
 
   protected:
@@ -101,9 +134,12 @@ class RemoteDatabase : public Xapian::Database::Internal {
      *			operations will never timeout.
      *  @param context_ The context to return with any error messages.
      *	@param writable	Is this a WritableDatabase?
+     *	@param compress	Should large messages be compressed?  This is
+     *			worthwhile over a network, but not over a local
+     *			pipe.
      */
     RemoteDatabase(int fd, double timeout_, const string & context_,
-		   bool writable);
+		   bool writable, bool compress = false);
 
     /// Receive a message from the server.
     reply_type get_message(string & message, reply_type required_type = REPLY_MAX) const;
@@ -163,6 +199,18 @@ class RemoteDatabase : public Xapian::Database::Internal {
      */
     bool get_remote_stats(bool nowait, Xapian::Weight::Internal &out);
 
+    /** Ask the remote server for more results from the current query.
+     *
+     *  Call get_mset() to read them.
+     *
+     *  @param first	The first result to return.
+     *  @param maxitems	The number of results to return.
+     *  @param w_min	Results with a lower weight than this aren't needed.
+     */
+    void send_get_more(Xapian::doccount first,
+		       Xapian::doccount maxitems,
+		       double w_min);
+
     /// Send the global stats to the remote server.
     void send_global_stats(Xapian::doccount first,
 			   Xapian::doccount maxitems,
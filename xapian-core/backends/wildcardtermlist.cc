@@ -0,0 +1,132 @@
+/** @file wildcardtermlist.cc
+ * @brief Filter a list of terms to those matching a wildcard pattern.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <config.h>
+
+#include "wildcardtermlist.h"
+
+#include "debuglog.h"
+#include "omassert.h"
+#include "stringutils.h"
+
+using namespace std;
+
+bool
+wildcard_matches(const string & pattern, const string & term)
+{
+    // Match greedily, backtracking to just after the most recent '*' on a
+    // mismatch.  Only the most recent '*' ever needs to be revisited, so
+    // this is O(pattern.size() * term.size()) in the worst case.
+    if (!pattern.empty() && pattern[0] == '*' &&
+	!term.empty() && C_isupper(term[0])) {
+	// A pattern with an empty prefix shouldn't match prefixed terms.
+	return false;
+    }
+
+    size_t p = 0, t = 0;
+    size_t star = string::npos, mark = 0;
+    while (t != term.size()) {
+	if (p != pattern.size() && pattern[p] == '*') {
+	    star = p++;
+	    mark = t;
+	} else if (p != pattern.size() && pattern[p] == term[t]) {
+	    ++p;
+	    ++t;
+	} else if (star != string::npos) {
+	    p = star + 1;
+	    t = ++mark;
+	} else {
+	    return false;
+	}
+    }
+    while (p != pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+WildcardTermList::~WildcardTermList()
+{
+    LOGCALL_DTOR(DB, "WildcardTermList");
+    delete tl;
+}
+
+void
+WildcardTermList::skip_unmatched()
+{
+    while (!tl->at_end() && !wildcard_matches(pattern, tl->get_termname())) {
+	TermList * res = tl->next();
+	if (res) {
+	    delete tl;
+	    tl = res;
+	}
+    }
+}
+
+string
+WildcardTermList::get_termname() const
+{
+    Assert(!at_end());
+    return tl->get_termname();
+}
+
+Xapian::doccount
+WildcardTermList::get_termfreq() const
+{
+    Assert(!at_end());
+    return tl->get_termfreq();
+}
+
+Xapian::termcount
+WildcardTermList::get_collection_freq() const
+{
+    Assert(!at_end());
+    return tl->get_collection_freq();
+}
+
+TermList *
+WildcardTermList::next()
+{
+    LOGCALL(DB, TermList *, "WildcardTermList::next", NO_ARGS);
+    TermList * res = tl->next();
+    if (res) {
+	delete tl;
+	tl = res;
+    }
+    skip_unmatched();
+    RETURN(NULL);
+}
+
+TermList *
+WildcardTermList::skip_to(const string & term)
+{
+    LOGCALL(DB, TermList *, "WildcardTermList::skip_to", term);
+    TermList * res = tl->skip_to(term);
+    if (res) {
+	delete tl;
+	tl = res;
+    }
+    skip_unmatched();
+    RETURN(NULL);
+}
+
+bool
+WildcardTermList::at_end() const
+{
+    return tl->at_end();
+}
@@ -0,0 +1,83 @@
+/** @file wildcardtermlist.h
+ * @brief Filter a list of terms to those matching a wildcard pattern.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef XAPIAN_INCLUDED_WILDCARDTERMLIST_H
+#define XAPIAN_INCLUDED_WILDCARDTERMLIST_H
+
+#include "alltermslist.h"
+
+#include <string>
+
+/** Test if @a term matches wildcard @a pattern.
+ *
+ *  Each '*' in @a pattern matches any sequence of bytes (including an
+ *  empty one) and every other byte must match exactly.
+ *
+ *  If @a pattern starts with '*' (so it has no term prefix) then terms
+ *  starting with a capital letter A-Z don't match, as by convention those
+ *  are prefixed terms from other fields.
+ */
+bool wildcard_matches(const std::string & pattern, const std::string & term);
+
+/// Filter an allterms list to those terms matching a wildcard pattern.
+class WildcardTermList : public AllTermsList {
+    /// Don't allow assignment.
+    void operator=(const WildcardTermList &);
+
+    /// Don't allow copying.
+    WildcardTermList(const WildcardTermList &);
+
+    /// The list being filtered.
+    TermList * tl;
+
+    /// The pattern to match.
+    std::string pattern;
+
+    /// Advance tl until it is at_end() or on a term matching pattern.
+    void skip_unmatched();
+
+  public:
+    /** Construct a WildcardTermList.
+     *
+     *  @param tl_	The list to filter, which we take ownership of.  This
+     *			will usually be an allterms list for the literal
+     *			prefix of @a pattern_.
+     *  @param pattern_	The pattern to match.
+     */
+    WildcardTermList(TermList * tl_, const std::string & pattern_)
+	: tl(tl_), pattern(pattern_) { }
+
+    /// Destructor.
+    ~WildcardTermList();
+
+    std::string get_termname() const;
+
+    Xapian::doccount get_termfreq() const;
+
+    Xapian::termcount get_collection_freq() const;
+
+    TermList * next();
+
+    TermList * skip_to(const std::string & term);
+
+    bool at_end() const;
+};
+
+#endif // XAPIAN_INCLUDED_WILDCARDTERMLIST_H
@@ -2,9 +2,11 @@ noinst_HEADERS +=\
 	common/append_filename_arg.h\
 	common/autoptr.h\
 	common/bitstream.h\
+	common/boundedcache.h\
 	common/closefrom.h\
 	common/compression_stream.h\
 	common/debuglog.h\
+	common/edgengram.h\
 	common/fd.h\
 	common/filetests.h\
 	common/fileutils.h\
@@ -41,7 +43,8 @@ noinst_HEADERS +=\
 	common/str.h\
 	common/stringutils.h\
 	common/submatch.h\
-	common/unaligned.h
+	common/unaligned.h\
+	common/unordered_map.h
 
 EXTRA_DIST +=\
 	common/dir_contents\
@@ -0,0 +1,65 @@
+/** @file boundedcache.h
+ * @brief Map used as a cache, with a limit on the number of entries.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef XAPIAN_INCLUDED_BOUNDEDCACHE_H
+#define XAPIAN_INCLUDED_BOUNDEDCACHE_H
+
+#include <cstddef>
+#include <map>
+
+/** A map from @a K to @a V holding at most @a MAX_ENTRIES entries.
+ *
+ *  When an entry is added to a full cache, all the existing entries are
+ *  discarded first.  Tracking which entry was least recently used would cost
+ *  on every lookup, and the caches this is used for are sized so that the
+ *  entries in use at once fit easily, so emptying it is rare and just means
+ *  a few entries get looked up again.
+ */
+template<class K, class V, size_t MAX_ENTRIES>
+class BoundedCache {
+    /// The cached entries.
+    std::map<K, V> entries;
+
+  public:
+    /// Return the cached value for @a key, or NULL if it isn't cached.
+    V * find(const K & key) {
+	typename std::map<K, V>::iterator i = entries.find(key);
+	if (i == entries.end()) return NULL;
+	return &i->second;
+    }
+
+    /** Return the cached value for @a key, adding it if it isn't cached.
+     *
+     *  A newly added value is default constructed.
+     */
+    V & insert(const K & key) {
+	if (entries.size() >= MAX_ENTRIES && entries.find(key) == entries.end())
+	    entries.clear();
+	return entries[key];
+    }
+
+    /// Remove any cached value for @a key.
+    void erase(const K & key) { entries.erase(key); }
+
+    /// Remove all the cached values.
+    void clear() { entries.clear(); }
+};
+
+#endif // XAPIAN_INCLUDED_BOUNDEDCACHE_H
@@ -35,17 +35,17 @@ CompressionStream::~CompressionStream() {
 
 
 void
-CompressionStream::compress(string & buf) {
-    if (!out || out_len < buf.size() - 1) {
+CompressionStream::compress(const string & buf, size_t max_out) {
+    if (!out || out_len < max_out) {
 	delete [] out;
 	out = NULL;
-	out_len = buf.size() - 1;
+	out_len = max_out;
 	out = new unsigned char[out_len];
     }
     deflate_zstream->avail_in = (uInt)buf.size();
     deflate_zstream->next_in = (Bytef *)const_cast<char *>(buf.data());
     deflate_zstream->next_out = out;
-    deflate_zstream->avail_out = (uInt)(buf.size() - 1);
+    deflate_zstream->avail_out = (uInt)max_out;
     zerr = deflate(deflate_zstream, Z_FINISH);
 }
 
@@ -81,10 +81,14 @@ CompressionStream::lazy_alloc_deflate_zstream() const {
 
     // -15 means raw deflate with 32K LZ77 window (largest)
     // memLevel 9 is the highest (8 is default)
+    //
+    // Tables which don't compress their tags still use compress() for the
+    // blocks they write to changesets, so use the default strategy for those.
+    int strategy = compress_strategy;
+    if (strategy == DONT_COMPRESS) strategy = Z_DEFAULT_STRATEGY;
     int err;
-    // FIXME:dc: this needs to really use compress_strategy if set
     err = deflateInit2(deflate_zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
-		       -15, 9, Z_DEFAULT_STRATEGY);
+		       -15, 9, strategy);
     if (rare(err != Z_OK)) {
 	if (err == Z_MEM_ERROR) {
 	    delete deflate_zstream;
@@ -40,7 +40,13 @@ class CompressionStream {
     /// Allocate the zstream for inflating, if not already allocated.
     void lazy_alloc_inflate_zstream() const;
 
-    void compress(string &);
+    /** Compress @a buf into out.
+     *
+     *  zerr is set to Z_STREAM_END if the compressed data fitted in
+     *  @a max_out bytes, which must be less than buf.size().
+     */
+    void compress(const string & buf, size_t max_out);
+
     void compress(byte *, int);
 };
 
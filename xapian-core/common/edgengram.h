@@ -0,0 +1,44 @@
+/** @file edgengram.h
+ * @brief Edge n-gram terms indexed for QueryParser::FLAG_PARTIAL.
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef XAPIAN_INCLUDED_EDGENGRAM_H
+#define XAPIAN_INCLUDED_EDGENGRAM_H
+
+#include <string>
+
+/** The first byte of every edge n-gram term.
+ *
+ *  Terms starting with this are reserved for edge n-grams (see
+ *  TermGenerator::set_max_edge_ngram_length()).  They're indexed with the
+ *  wdf of the words they're taken from, so that they weight partial words
+ *  like the terms a wildcard would expand to.  Brass databases created with
+ *  Xapian::DB_EDGE_NGRAMS don't count them in the document length; other
+ *  databases treat them like any other term.
+ */
+const char EDGE_NGRAM_PREFIX = '~';
+
+/// Test if @a term is an edge n-gram term.
+inline bool
+is_edge_ngram_term(const std::string & term)
+{
+    return !term.empty() && term[0] == EDGE_NGRAM_PREFIX;
+}
+
+#endif // XAPIAN_INCLUDED_EDGENGRAM_H
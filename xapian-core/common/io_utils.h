@@ -62,6 +62,22 @@ inline bool io_sync(int fd)
 #endif
 }
 
+/** Start writing data previously written to file descriptor fd to disk.
+ *
+ *  This doesn't wait for the data to be written - io_sync() must still be
+ *  called before relying on it being on disk.  But starting writeback on
+ *  several files before syncing any of them allows the I/O for them to be
+ *  overlapped, rather than each io_sync() call having to start it.
+ */
+inline void io_sync_start(int fd)
+{
+#ifdef HAVE_SYNC_FILE_RANGE
+    (void)sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#else
+    (void)fd;
+#endif
+}
+
 /** Read n bytes (or until EOF) into block pointed to by p from file descriptor
  *  fd.
  *
@@ -46,8 +46,18 @@
 // 35: 1.1.5 Support for add_spelling() and remove_spelling().
 // 35.1: 1.2.4 Support for metadata_keys_begin().
 // 36: 1.3.0 REPLY_UPDATE and REPLY_GREETING merged, and more...
+// 36.1: 1.3.0 MSG_COMPRESSION allows large messages to be zlib compressed.
+// 36.2: 1.3.0 MSG_QUERYMSET runs a query given the global stats.
+// 36.3: 1.3.0 MSG_GETMORE fetches results from the last query in batches.
 #define XAPIAN_REMOTE_PROTOCOL_MAJOR_VERSION 36
-#define XAPIAN_REMOTE_PROTOCOL_MINOR_VERSION 0
+#define XAPIAN_REMOTE_PROTOCOL_MINOR_VERSION 3
+
+/** Flag set in the message type byte if the message data is compressed.
+ *
+ *  The message data is then the encoded length of the uncompressed data
+ *  followed by the data compressed with zlib's raw deflate.
+ */
+#define MESSAGE_COMPRESSED 0x80
 
 /** Message types (client -> server).
  *
@@ -84,6 +94,9 @@ enum message_type {
     MSG_GETMSET,		// Get MSet
     MSG_SHUTDOWN,		// Shutdown
     MSG_METADATAKEYLIST,	// Iterator for metadata keys
+    MSG_COMPRESSION,		// Compress large replies
+    MSG_QUERYMSET,		// Run Query and get MSet
+    MSG_GETMORE,		// Get more of the MSet
     MSG_MAX
 };
 
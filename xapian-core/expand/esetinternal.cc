@@ -139,7 +139,7 @@ ESet::Internal::expand(Xapian::termcount max_esize,
 		       const Xapian::Database & db,
 		       const RSet & rset,
 		       const Xapian::ExpandDecider * edecider,
-		       const Xapian::Internal::ExpandWeight & eweight,
+		       Xapian::Internal::ExpandWeight & eweight,
 		       double min_wt)
 {
     LOGCALL_VOID(EXPAND, "ESet::Internal::expand", max_esize | db | rset | edecider | eweight);
@@ -35,12 +35,12 @@ namespace Xapian {
 namespace Internal {
 
 double
-ExpandWeight::get_weight(TermList * merger, const string & term) const
+ExpandWeight::get_weight(TermList * merger, const string & term)
 {
     LOGCALL(MATCH, double, "ExpandWeight::get_weight", merger | term);
 
     // Accumulate the stats for this term across all relevant documents.
-    ExpandStats stats(avlen, expand_k);
+    stats.clear();
     merger->accumulate_stats(stats);
 
     double termfreq = stats.termfreq;
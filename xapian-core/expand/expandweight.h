@@ -63,8 +63,19 @@ class ExpandStats {
 	  dbsize(0), termfreq(0), multiplier(0), rtermfreq(0), db_index(0) {
     }
 
+    /** Accumulate the stats for the current term in one relevant document.
+     *
+     *  @param wdf	 The wdf of the term in the document.
+     *  @param doclen	 The length of the document.
+     *  @param tl	 The document's termlist, positioned on the term.  We
+     *			 only call tl.get_termfreq() for the first document
+     *			 we see from each sub-database, since it generally
+     *			 requires a lookup in the database and the answer
+     *			 won't change.
+     *  @param subdbsize The number of documents in the sub-database.
+     */
     void accumulate(Xapian::termcount wdf, Xapian::termcount doclen,
-		    Xapian::doccount subtf, Xapian::doccount subdbsize) {
+		    const TermList & tl, Xapian::doccount subdbsize) {
 	// Boolean terms may have wdf == 0, but treat that as 1 so such terms
 	// get a non-zero weight.
 	if (wdf == 0) wdf = 1;
@@ -78,9 +89,23 @@ class ExpandStats {
 	    if (db_index >= dbs_seen.size()) dbs_seen.resize(db_index + 1);
 	    dbs_seen[db_index] = true;
 	    dbsize += subdbsize;
-	    termfreq += subtf;
+	    termfreq += tl.get_termfreq();
 	}
     }
+
+    /** Reset to accumulate stats for another term.
+     *
+     *  This allows us to reuse one ExpandStats object for every term
+     *  considered, rather than reallocating dbs_seen for each one.
+     */
+    void clear() {
+	dbs_seen.assign(dbs_seen.size(), false);
+	dbsize = 0;
+	termfreq = 0;
+	multiplier = 0;
+	rtermfreq = 0;
+	db_index = 0;
+    }
 };
 
 /// Class for calculating probabilistic ESet term weights.
@@ -112,6 +137,9 @@ class ExpandWeight {
     /// Parameter k in the probabilistic expand weighting formula.
     double expand_k;
 
+    /// Stats object, reused for each term we calculate the weight of.
+    ExpandStats stats;
+
 public:
     /** Constructor.
      *
@@ -129,14 +157,14 @@ public:
 		 double expand_k_)
 	: db(db_), dbsize(db.get_doccount()), avlen(db.get_avlength()),
 	  rsize(rsize_), use_exact_termfreq(use_exact_termfreq_),
-	  expand_k(expand_k_) { }
+	  expand_k(expand_k_), stats(avlen, expand_k) { }
 
     /** Get the expand weight.
      *
      *  @param merger The tree of TermList objects.
      *  @param term The current term name.
      */
-    double get_weight(TermList * merger, const std::string & term) const;
+    double get_weight(TermList * merger, const std::string & term);
 };
 
 }
@@ -548,6 +548,9 @@ class XAPIAN_VISIBILITY_DEFAULT WritableDatabase : public Database {
 	 *    none exists
 	 *  - Xapian::DB_OPEN open for read/write; fail if no db exists
 	 *
+	 *  which may be bitwise-ORed with Xapian::DB_PERMUTERM and
+	 *  Xapian::DB_EDGE_NGRAMS.
+	 *
 	 *  @exception Xapian::DatabaseCorruptError will be thrown if the
 	 *             database is in a corrupt state.
 	 *
@@ -968,6 +971,34 @@ const int DB_CREATE = 2;
 const int DB_CREATE_OR_OVERWRITE = 3;
 /** Open for read/write; fail if no db exists. */
 const int DB_OPEN = 4;
+/** Keep an index of rotated terms, to speed up leading wildcards.
+ *
+ *  This can be bitwise-ORed with one of the actions above.  If the database
+ *  doesn't already have a permuterm index, one is built from the existing
+ *  terms and then kept up to date as documents are added, replaced and
+ *  deleted.  Wildcard patterns starting with '*' (or with '*' before
+ *  literal text, such as "*ing" or "*vers*") are then answered by a range
+ *  scan of this index rather than by looking at every term in the
+ *  database.  The index stores each term once per character, so it's
+ *  typically several times the size of the term dictionary.
+ *
+ *  Currently only supported by the brass backend, and ignored by others.
+ */
+const int DB_PERMUTERM = 0x100;
+
+/** When creating a database, don't count edge n-grams in document lengths.
+ *
+ *  This can be bitwise-ORed with one of the actions above, and only has an
+ *  effect when a new database is created (it's recorded in the database, and
+ *  ignored when opening an existing one).  Terms starting with '~', which is
+ *  how Xapian::TermGenerator names the edge n-grams it generates (see
+ *  TermGenerator::set_max_edge_ngram_length()), then don't count towards the
+ *  lengths of the documents they're in, so indexing edge n-grams doesn't
+ *  change how document length affects weighting.
+ *
+ *  Currently only supported by the brass backend, and ignored by others.
+ */
+const int DB_EDGE_NGRAMS = 0x200;
 
 /** Show a short-format display of the B-tree contents.
  *
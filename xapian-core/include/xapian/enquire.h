@@ -208,6 +208,41 @@ class XAPIAN_VISIBILITY_DEFAULT MSet {
 	 */
 	double get_max_attained() const;
 
+	/** Time spent preparing to run the query, in seconds.
+	 *
+	 *  This includes gathering the statistics needed for weighting and
+	 *  building the tree of posting lists to evaluate the query with.
+	 *
+	 *  These timings are always collected as the overhead is just a few
+	 *  clock reads per query.  Remote servers don't send their timings
+	 *  back, so when searching remote databases this and
+	 *  get_match_time() are as measured by the client, including time
+	 *  spent waiting for the servers.
+	 */
+	double get_setup_time() const;
+
+	/** Time spent running the match, in seconds.
+	 *
+	 *  This includes reading posting lists, weighting, sorting and
+	 *  collapsing the candidate documents, but not time spent later
+	 *  fetching documents from the MSet.
+	 */
+	double get_match_time() const;
+
+	/** The number of candidate documents the matcher looked at.
+	 *
+	 *  This counts each document returned by the posting list tree for
+	 *  the query, before any weight cutoff, match decider or collapsing
+	 *  is applied, so comparing it with get_matches_estimated() shows how
+	 *  much of the matching work was spent on documents which were
+	 *  rejected.
+	 *
+	 *  Remote servers don't report how many candidates they looked at, so
+	 *  for a remote database this only counts the documents the server
+	 *  returns.
+	 */
+	Xapian::doccount get_candidates_considered() const;
+
 	/** The number of items in this MSet */
 	Xapian::doccount size() const;
 
@@ -103,7 +103,39 @@ class XAPIAN_VISIBILITY_DEFAULT Query {
 	OP_ELITE_SET = 10,
 	OP_VALUE_GE = 11,
 	OP_VALUE_LE = 12,
-	OP_SYNONYM = 13
+	OP_SYNONYM = 13,
+
+	/** Match any term starting with a given prefix.
+	 *
+	 *  If the pattern contains '*' then it must instead match the whole
+	 *  term, with each '*' matching any sequence of characters - for
+	 *  example "*ing" or "*vers*".  Such patterns are much cheaper to
+	 *  expand for a database opened with Xapian::DB_PERMUTERM.  A pattern
+	 *  starting with '*' doesn't match terms starting with a capital
+	 *  letter A-Z, since those are conventionally prefixed terms.
+	 *
+	 *  The wildcard is expanded against each database when the match
+	 *  runs, and the matching terms are combined as if with OP_SYNONYM.
+	 *  This avoids building a Query object for every term the wildcard
+	 *  expands to, which matters for short prefixes.
+	 *
+	 *  Use Query(OP_WILDCARD, pattern, max_expansion, max_type) to
+	 *  construct such a query.
+	 */
+	OP_WILDCARD = 14
+    };
+
+    /** How to handle an OP_WILDCARD which expands to too many terms. */
+    enum {
+	/** Throw WildcardError if the expansion limit is exceeded. */
+	WILDCARD_LIMIT_ERROR,
+	/** Stop expanding once the limit is reached.
+	 *
+	 *  The terms used are the first max_expansion in sort order.
+	 */
+	WILDCARD_LIMIT_FIRST,
+	/** Use the max_expansion terms with the highest term frequency. */
+	WILDCARD_LIMIT_MOST_FREQUENT
     };
 
     /// Default constructor.
@@ -164,6 +196,22 @@ class XAPIAN_VISIBILITY_DEFAULT Query {
     Query(op op_, Xapian::valueno slot,
 	  const std::string & begin, const std::string & end);
 
+    /** Construct an OP_WILDCARD query.
+     *
+     *  @param op_		Must be OP_WILDCARD.
+     *  @param pattern	The prefix to match terms against, or a pattern
+     *			containing '*' (see OP_WILDCARD).
+     *  @param max_expansion	The maximum number of terms to expand to in
+     *				each database (default: 0, meaning no limit).
+     *  @param max_type	How to handle exceeding max_expansion:
+     *			WILDCARD_LIMIT_ERROR (the default),
+     *			WILDCARD_LIMIT_FIRST or
+     *			WILDCARD_LIMIT_MOST_FREQUENT.
+     */
+    Query(op op_, const std::string & pattern,
+	  Xapian::termcount max_expansion = 0,
+	  int max_type = WILDCARD_LIMIT_ERROR);
+
     template<typename I>
     Query(op op_, I begin, I end, Xapian::termcount window = 0)
     {
@@ -189,6 +237,11 @@ class XAPIAN_VISIBILITY_DEFAULT Query {
 # endif
 #endif
 
+    /** Begin iterator for the terms in the query.
+     *
+     *  An OP_WILDCARD subquery contributes the terms it expanded to when the
+     *  query was last run by Enquire::get_mset() (so none before then).
+     */
     const TermIterator get_terms_begin() const;
 
     const TermIterator XAPIAN_NOTHROW(get_terms_end() const) {
@@ -314,7 +367,10 @@ class InvertedQuery_ {
     InvertedQuery_(const InvertedQuery_ & o) : query(o.query) { }
 
     operator Query() const {
-	return Query(Query::OP_AND_NOT, Query::MatchAll, query);
+	// Use Query(std::string()) rather than Query::MatchAll, so that the
+	// result doesn't share a reference count with a static object which
+	// other threads may also be copying.
+	return Query(Query::OP_AND_NOT, Query(std::string()), query);
     }
 
     friend const InvertedQuery_ operator~(const Query &q);
@@ -370,6 +426,9 @@ class Query::Internal : public Xapian::Internal::intrusive_base {
 
     // Pass argument as void* to avoid need to include <vector>.
     virtual void gather_terms(void * void_terms) const;
+
+    // Pass argument as void* to avoid need to include <vector>.
+    virtual void gather_wildcards(void * void_wildcards) const;
 };
 
 }
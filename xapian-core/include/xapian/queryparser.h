@@ -469,6 +469,18 @@ class XAPIAN_VISIBILITY_DEFAULT QueryParser {
 	 */
 	FLAG_AUTO_MULTIWORD_SYNONYMS = 1024,
 
+	/** Support wildcards at the start of a term.
+	 *
+	 *  For example, "*ing" matches terms ending "ing", and "*vers*"
+	 *  matches terms containing "vers".  Without an index of rotated
+	 *  terms (see Xapian::DB_PERMUTERM) these have to look at every term
+	 *  in the database, so this isn't enabled by FLAG_WILDCARD.
+	 *
+	 *  NB: You need to tell the QueryParser object which database to
+	 *  expand wildcards from by calling set_database.
+	 */
+	FLAG_WILDCARD_LEADING = 2048,
+
 	/** The default flags.
 	 *
 	 *  Used if you don't explicitly pass any to @a parse_query().
@@ -482,7 +494,13 @@ class XAPIAN_VISIBILITY_DEFAULT QueryParser {
     /// Stemming strategies, for use with set_stemming_strategy().
     typedef enum { STEM_NONE, STEM_SOME, STEM_ALL, STEM_ALL_Z } stem_strategy;
 
-    /// Copy constructor.
+    /** Copy constructor.
+     *
+     *  The copy shares its internals with @a o, so the two can't be used
+     *  at the same time from different threads.  To parse queries in
+     *  several threads, create and configure a separate QueryParser in
+     *  each, with its own Stem and Database objects.
+     */
     QueryParser(const QueryParser & o);
 
     /// Assignment.
@@ -569,11 +587,47 @@ class XAPIAN_VISIBILITY_DEFAULT QueryParser {
      *
      *  Note: you must also set FLAG_WILDCARD for wildcard expansion to happen.
      *
+     *  Wildcards are expanded lazily when the match runs, using
+     *  Query::OP_WILDCARD.
+     *
+     *  A wildcard which expands to more terms than this causes
+     *  QueryParserError to be thrown when parsing.
+     *
      *  @param limit	The maximum number of terms each wildcard in the query
      *			can expand to, or 0 for no limit (which is the default).
      */
     void set_max_wildcard_expansion(Xapian::termcount limit);
 
+    /** Specify the maximum expansion of a wildcard term, and how to
+     *  handle a wildcard which would expand to more terms.
+     *
+     *  @param limit	The maximum number of terms each wildcard in the query
+     *			can expand to, or 0 for no limit (which is the default).
+     *  @param limit_type	How to handle a wildcard which expands to more
+     *			than @a limit terms: Query::WILDCARD_LIMIT_ERROR throws
+     *			QueryParserError when parsing (like the overload
+     *			without this parameter), Query::WILDCARD_LIMIT_FIRST
+     *			uses the first @a limit terms, and
+     *			Query::WILDCARD_LIMIT_MOST_FREQUENT uses the @a limit
+     *			terms which index the most documents.
+     */
+    void set_max_wildcard_expansion(Xapian::termcount limit, int limit_type);
+
+    /** Use edge n-gram terms for FLAG_PARTIAL.
+     *
+     *  If the documents were indexed with
+     *  TermGenerator::set_max_edge_ngram_length(), pass the same value here.
+     *  A partial word of at most this many characters is then searched for
+     *  as a single edge n-gram term, rather than being expanded from the
+     *  database's term list.  Longer partial words are expanded as usual.
+     *  The n-gram terms start with "~", which is reserved for them.
+     *
+     *  @param max_edge_ngram_length	The maximum length in Unicode
+     *					characters.  Default is 0, which means
+     *					edge n-grams aren't used.
+     */
+    void set_max_edge_ngram_length(unsigned max_edge_ngram_length);
+
     /** Parse a query.
      *
      *  @param query_string  A free-text query as entered by a user
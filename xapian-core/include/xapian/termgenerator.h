@@ -137,6 +137,35 @@ class XAPIAN_VISIBILITY_DEFAULT TermGenerator {
      */
     void set_max_word_length(unsigned max_word_length);
 
+    /** Set the maximum length of edge n-gram to index.
+     *
+     *  If this is non-zero, then for each word indexed, terms for the first
+     *  1, 2, ... characters of it (up to this length, or the whole word if
+     *  it's shorter) are also generated.  These are named by adding "~"
+     *  before the term prefix (so "cat" with prefix "XT" gives "~XTc",
+     *  "~XTca" and "~XTcat").  Each is added with the same wdf as the word,
+     *  so a partial word is weighted much as the terms it would expand to
+     *  are.  Like any other terms, they count towards the document length
+     *  unless the database was created with Xapian::DB_EDGE_NGRAMS (which
+     *  is currently only supported by the brass backend).
+     *
+     *  Terms starting with "~" are reserved for edge n-grams: if you add any
+     *  other terms starting with "~" to a document, they may be matched by
+     *  partial queries, and won't be counted in its length in a database
+     *  created with Xapian::DB_EDGE_NGRAMS.
+     *
+     *  This makes the index larger, but QueryParser can then handle a word
+     *  with FLAG_PARTIAL as a single term rather than by scanning the term
+     *  list - see QueryParser::set_max_edge_ngram_length().  If you only
+     *  want to offer completions from some documents, you can enable this
+     *  only when indexing those.
+     *
+     *  @param max_edge_ngram_length	The maximum length in Unicode
+     *					characters.  Default is 0, which means
+     *					no edge n-grams are generated.
+     */
+    void set_max_edge_ngram_length(unsigned max_edge_ngram_length);
+
     /** Index some text.
      *
      * @param itor	Utf8Iterator pointing to the text to index.
@@ -361,6 +361,9 @@ class XAPIAN_VISIBILITY_DEFAULT BM25Weight : public Weight {
     /// The minimum normalised document length value.
     Xapian::doclength param_min_normlen;
 
+    /// Allow the matcher to calculate get_sumpart() without a virtual call.
+    friend class Weight::Internal;
+
     BM25Weight * clone() const;
 
     void init(double factor);
@@ -468,6 +471,9 @@ class XAPIAN_VISIBILITY_DEFAULT TradWeight : public Weight {
     /// The parameter in the formula.
     double param_k;
 
+    /// Allow the matcher to calculate get_sumpart() without a virtual call.
+    friend class Weight::Internal;
+
     TradWeight * clone() const;
 
     void init(double factor);
@@ -13,6 +13,7 @@ noinst_HEADERS +=\
 	matcher/msetpostlist.h\
 	matcher/multiandpostlist.h\
 	matcher/multimatch.h\
+	matcher/multiorpostlist.h\
 	matcher/multixorpostlist.h\
 	matcher/orpostlist.h\
 	matcher/phrasepostlist.h\
@@ -50,6 +51,7 @@ lib_src +=\
 	matcher/msetpostlist.cc\
 	matcher/multiandpostlist.cc\
 	matcher/multimatch.cc\
+	matcher/multiorpostlist.cc\
 	matcher/multixorpostlist.cc\
 	matcher/orpostlist.cc\
 	matcher/phrasepostlist.cc\
@@ -34,6 +34,11 @@ CollapseData::add_item(const Xapian::Internal::MSetItem & item,
 		       Xapian::Internal::MSetItem & old_item)
 {
     if (items.size() < collapse_max) {
+	if (items.size() == 1) {
+	    // Allow for the extra entry we temporarily push_back() when
+	    // replacing an item below.
+	    items.reserve(min(collapse_max, COLLAPSE_RESERVE_MAX) + 1);
+	}
 	items.push_back(item);
 	items.back().collapse_key = string();
 	return ADDED;
@@ -88,7 +93,7 @@ Collapser::process(Xapian::Internal::MSetItem & item,
 	return EMPTY;
     }
 
-    map<string, CollapseData>::iterator oldkey;
+    unordered_map<string, CollapseData>::iterator oldkey;
     oldkey = table.find(item.collapse_key);
     if (oldkey == table.end()) {
 	// We've not seen this collapse key before.
@@ -112,7 +117,8 @@ Xapian::doccount
 Collapser::get_collapse_count(const string & collapse_key, int percent_cutoff,
 			      double min_weight) const
 {
-    map<string, CollapseData>::const_iterator key = table.find(collapse_key);
+    unordered_map<string, CollapseData>::const_iterator key;
+    key = table.find(collapse_key);
     // If a collapse key is present in the MSet, it must be in our table.
     Assert(key != table.end());
 
@@ -147,7 +153,7 @@ Collapser::get_matches_lower_bound() const
     // many documents.
 #if 0
     Xapian::doccount max_kept = 0;
-    map<string, CollapseData>::const_iterator i;
+    unordered_map<string, CollapseData>::const_iterator i;
     for (i = table.begin(); i != table.end(); ++i) {
 	if (i->second.get_collapse_count() > max_kept) {
 	    max_kept = i->second.get_collapse_count();
@@ -26,7 +26,7 @@
 #include "api/omenquireinternal.h"
 #include "api/postlist.h"
 
-#include <map>
+#include "unordered_map.h"
 
 /// Enumeration reporting how a document was handled by the Collapser.
 typedef enum {
@@ -36,6 +36,13 @@ typedef enum {
     REPLACED
 } collapse_result;
 
+/** The most entries CollapseData will reserve space for in one go.
+ *
+ *  If collapse_max is larger than this, the vector grows as needed beyond
+ *  this point.
+ */
+const Xapian::doccount COLLAPSE_RESERVE_MAX = 16;
+
 /// Class tracking information for a given value of the collapse key.
 class CollapseData {
     /** Currently kept MSet entries for this value of the collapse key.
@@ -43,9 +50,11 @@ class CollapseData {
      *  If collapse_max > 1, then this is a min-heap once items.size()
      *  reaches collapse_max.
      *
-     *  FIXME: We expect collapse_max to be small, so perhaps we should
-     *  preallocate space for that many entries and/or allocate space in
-     *  larger blocks to divvy up?
+     *  We expect collapse_max to be small, so when a second item arrives
+     *  we reserve space for all the items we might need (up to a limit of
+     *  COLLAPSE_RESERVE_MAX) rather than growing the vector one
+     *  reallocation at a time.  Most collapse key values are only seen
+     *  once, so we don't reserve space until then.
      */
     vector<Xapian::Internal::MSetItem> items;
 
@@ -85,8 +94,13 @@ class CollapseData {
 
 /// The Collapser class tracks collapse keys and the documents they match.
 class Collapser {
-    /// Map from collapse key values to the items we're keeping for them.
-    std::map<std::string, CollapseData> table;
+    /** Map from collapse key values to the items we're keeping for them.
+     *
+     *  We never need to iterate this in key order, so we use a hash table
+     *  which makes the lookup for each candidate document O(1) rather than
+     *  needing O(log n) string comparisons.
+     */
+    std::unordered_map<std::string, CollapseData> table;
 
     /// How many items we're currently keeping in @a table.
     Xapian::doccount entry_count;
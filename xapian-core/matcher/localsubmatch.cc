@@ -133,9 +133,10 @@ LocalSubMatch::make_wt(const string& term, Xapian::termcount wqf, double factor)
 }
 
 LeafPostList *
-LocalSubMatch::open_post_list(const string& term, double max_part)
+LocalSubMatch::open_post_list(const string& term, double max_part,
+			      const LeafPostList * hint)
 {
-    LOGCALL(MATCH, LeafPostList *, "LocalSubMatch::open_post_list", term | max_part);
+    LOGCALL(MATCH, LeafPostList *, "LocalSubMatch::open_post_list", term | max_part | hint);
     if (term_info) {
 	Xapian::doccount tf = stats->get_termfreq(term);
 	using namespace Xapian;
@@ -152,5 +153,15 @@ LocalSubMatch::open_post_list(const string& term, double max_part)
 	// is especially efficient if there are no gaps in the docids.
 	RETURN(db->open_post_list(string()));
     }
+    if (hint) {
+	LeafPostList * pl = hint->open_nearby_postlist(term);
+	if (pl) RETURN(pl);
+    }
     RETURN(db->open_post_list(term));
 }
+
+const vector<string> *
+LocalSubMatch::get_wildcard_expansion(const Xapian::Internal::QueryWildcard * wildcard) const
+{
+    return stats->get_wildcard_expansion(db, wildcard);
+}
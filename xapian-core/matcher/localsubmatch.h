@@ -30,6 +30,8 @@
 #include "xapian/weight.h"
 
 #include <map>
+#include <string>
+#include <vector>
 
 class LocalSubMatch : public SubMatch {
     /// Don't allow assignment.
@@ -100,7 +102,19 @@ class LocalSubMatch : public SubMatch {
 			     Xapian::termcount wqf,
 			     double factor);
 
-    LeafPostList * open_post_list(const std::string& term, double max_part);
+    /** Open the postlist for @a term.
+     *
+     *  @param hint	A previously opened postlist which may be able to open
+     *			the postlist more cheaply, or NULL.
+     */
+    LeafPostList * open_post_list(const std::string& term, double max_part,
+				  const LeafPostList * hint);
+
+    /** Return the terms @a wildcard expanded to in our sub-database when
+     *  the stats were gathered, or NULL if they weren't gathered here.
+     */
+    const std::vector<std::string> *
+    get_wildcard_expansion(const Xapian::Internal::QueryWildcard * wildcard) const;
 };
 
 #endif /* XAPIAN_INCLUDED_LOCALSUBMATCH_H */
@@ -63,8 +63,9 @@ msetcmp_by_value(const Xapian::Internal::MSetItem &a,
 	if (a.did == 0) return false;
 	if (b.did == 0) return true;
     }
-    if (a.sort_key > b.sort_key) return FORWARD_VALUE;
-    if (a.sort_key < b.sort_key) return !FORWARD_VALUE;
+    int c = a.compare_sort_key(b);
+    if (c > 0) return FORWARD_VALUE;
+    if (c < 0) return !FORWARD_VALUE;
     return msetcmp_by_did<FORWARD_DID, FORWARD_VALUE>(a, b);
 }
 
@@ -78,8 +79,9 @@ msetcmp_by_value_then_relevance(const Xapian::Internal::MSetItem &a,
 	if (a.did == 0) return false;
 	if (b.did == 0) return true;
     }
-    if (a.sort_key > b.sort_key) return FORWARD_VALUE;
-    if (a.sort_key < b.sort_key) return !FORWARD_VALUE;
+    int c = a.compare_sort_key(b);
+    if (c > 0) return FORWARD_VALUE;
+    if (c < 0) return !FORWARD_VALUE;
     if (a.wt > b.wt) return true;
     if (a.wt < b.wt) return false;
     return msetcmp_by_did<FORWARD_DID, FORWARD_VALUE>(a, b);
@@ -97,8 +99,9 @@ msetcmp_by_relevance_then_value(const Xapian::Internal::MSetItem &a,
     }
     if (a.wt > b.wt) return true;
     if (a.wt < b.wt) return false;
-    if (a.sort_key > b.sort_key) return FORWARD_VALUE;
-    if (a.sort_key < b.sort_key) return !FORWARD_VALUE;
+    int c = a.compare_sort_key(b);
+    if (c > 0) return FORWARD_VALUE;
+    if (c < 0) return !FORWARD_VALUE;
     return msetcmp_by_did<FORWARD_DID, FORWARD_VALUE>(a, b);
 }
 
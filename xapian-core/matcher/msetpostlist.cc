@@ -24,6 +24,9 @@
 
 #include "debuglog.h"
 #include "omassert.h"
+#ifdef XAPIAN_HAS_REMOTE_BACKEND
+# include "remotesubmatch.h"
+#endif
 
 Xapian::doccount
 MSetPostList::get_termfreq_min() const
@@ -110,6 +113,12 @@ MSetPostList::next(double w_min)
     Assert(cursor == -1 || !at_end());
     ++cursor;
     if (decreasing_relevance) {
+#ifdef XAPIAN_HAS_REMOTE_BACKEND
+	// If we've run out, see if there are more items which could have
+	// enough weight.
+	if (at_end() && more && !more->get_more(*mset_internal, w_min))
+	    more = NULL;
+#endif
 	// MSet items are in decreasing weight order, so if the current item
 	// doesn't have enough weight, none of the remaining items will, so
 	// skip straight to the end.
@@ -26,6 +26,8 @@
 #include "api/omenquireinternal.h"
 #include "api/postlist.h"
 
+class RemoteSubMatch;
+
 /** PostList returning entries from an MSet.
  *
  *  This class is used with the remote backend.  We perform a match on the
@@ -51,10 +53,17 @@ class MSetPostList : public PostList {
      */
     bool decreasing_relevance;
 
+    /** The RemoteSubMatch to ask for more entries when we run out, or NULL.
+     *
+     *  Only used if decreasing_relevance is true.
+     */
+    RemoteSubMatch * more;
+
   public:
-    MSetPostList(const Xapian::MSet mset, bool decreasing_relevance_)
+    MSetPostList(const Xapian::MSet mset, bool decreasing_relevance_,
+		 RemoteSubMatch * more_ = NULL)
 	: cursor(-1), mset_internal(mset.internal),
-	  decreasing_relevance(decreasing_relevance_) { }
+	  decreasing_relevance(decreasing_relevance_), more(more_) { }
 
     Xapian::doccount get_termfreq_min() const;
 
@@ -33,6 +33,7 @@
 #include "submatch.h"
 #include "localsubmatch.h"
 #include "omassert.h"
+#include "realtime.h"
 #include "api/omenquireinternal.h"
 
 #include "api/emptypostlist.h"
@@ -255,7 +256,16 @@ MultiMatch::MultiMatch(const Xapian::Database &db_,
 				  subrsets[i], matchspies);
 		bool decreasing_relevance =
 		    (sort_by == REL || sort_by == REL_VAL);
-		smatch = new RemoteSubMatch(rem_db, decreasing_relevance, matchspies);
+		// If results come back in decreasing weight order, we can fetch
+		// them in batches and stop once no more can make it into the
+		// MSet.  We can't do that if collapsing (since we'd need the
+		// collapse counts) or if there are matchspies (since they'd see
+		// documents again for each batch).
+		bool batched = (decreasing_relevance && collapse_max == 0 &&
+				matchspies.empty());
+		smatch = new RemoteSubMatch(rem_db, decreasing_relevance,
+					    matchspies,
+					    batched ? number_of_subdbs : 0);
 		is_remote[i] = true;
 	    } else {
 		smatch = new LocalSubMatch(subdb, query, qlen, subrsets[i], weight);
@@ -310,6 +320,8 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
     LOGCALL_VOID(MATCH, "MultiMatch::get_mset", first | maxitems | check_at_least | Literal("mset") | stats | Literal("mdecider") | Literal("sorter"));
     AssertRel(check_at_least,>=,maxitems);
 
+    double start_time = RealTime::now();
+
     if (query.empty()) {
 	mset = Xapian::MSet(new Xapian::MSet::Internal());
 	mset.internal->firstitem = first;
@@ -326,6 +338,11 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 	rem_match = static_cast<RemoteSubMatch*>(leaves[0].get());
 	rem_match->start_match(first, maxitems, check_at_least, stats);
 	rem_match->get_mset(mset);
+	mset.internal->match_time = RealTime::now() - start_time;
+	// The server doesn't tell us how many candidates it considered, so
+	// count the documents it returned, as we would if there were other
+	// databases being searched too.
+	mset.internal->candidates_considered = mset.size();
 	return;
     }
 #endif
@@ -407,6 +424,8 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 
     LOGLINE(MATCH, "pl = (" << pl->get_description() << ")");
 
+    double match_start_time = RealTime::now();
+
 #ifdef XAPIAN_DEBUG_LOG
     {
 	map<string, Xapian::MSet::Internal::TermFreqAndWeight>::const_iterator tfwi;
@@ -477,9 +496,14 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 					   max_possible, greatest_wt, items,
 					   termfreqandwts,
 					   0));
+	mset.internal->setup_time = match_start_time - start_time;
+	mset.internal->match_time = RealTime::now() - match_start_time;
 	return;
     }
 
+    // Number of documents returned by the postlist tree.
+    Xapian::doccount candidates_considered = 0;
+
     // Number of documents considered by a decider.
     Xapian::doccount decider_considered = 0;
     // Number of documents denied by the decider.
@@ -558,6 +582,7 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 	    LOGLINE(MATCH, "Reached end of potential matches");
 	    break;
 	}
+	++candidates_considered;
 
 	// Only calculate the weight if we need it for mcmp, or there's a
 	// percentage or weight cutoff in effect.  Otherwise we calculate it
@@ -579,9 +604,9 @@ MultiMatch::get_mset(Xapian::doccount first, Xapian::doccount maxitems,
 	Xapian::Internal::MSetItem new_item(wt, did);
 	if (sort_by != REL) {
 	    if (sorter) {
-		new_item.sort_key = (*sorter)(doc);
+		new_item.set_sort_key((*sorter)(doc));
 	    } else {
-		new_item.sort_key = vsdoc.get_value(sort_key);
+		new_item.set_sort_key(vsdoc.get_value(sort_key));
 	    }
 
 	    // We're sorting by value (in part at least), so compare the item
@@ -1097,4 +1122,7 @@ new_greatest_weight:
 				       max_possible, greatest_wt, items,
 				       termfreqandwts,
 				       percent_scale * 100.0));
+    mset.internal->setup_time = match_start_time - start_time;
+    mset.internal->match_time = RealTime::now() - match_start_time;
+    mset.internal->candidates_considered = candidates_considered;
 }
@@ -130,6 +130,16 @@ class MultiMatch
 		      const Xapian::MatchDecider * mdecider,
 		      const Xapian::KeyMaker * sorter);
 
+	/** Set the weight cutoff for subsequent calls to get_mset().
+	 *
+	 *  Used by the remote server when the client asks for more results
+	 *  and tells us the minimum weight which could still make it into its
+	 *  MSet.
+	 */
+	void set_weight_cutoff(double weight_cutoff_) {
+	    weight_cutoff = weight_cutoff_;
+	}
+
 	/** Called by postlists to indicate that they've rearranged themselves
 	 *  and the maxweight now possible is smaller.
 	 */
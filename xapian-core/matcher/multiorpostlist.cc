@@ -0,0 +1,493 @@
+/** @file multiorpostlist.cc
+ * @brief N-way OR postlist
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <config.h>
+
+#include "multiorpostlist.h"
+
+#include "andmaybepostlist.h"
+#include "branchpostlist.h"
+#include "debuglog.h"
+#include "multimatch.h"
+#include "omassert.h"
+
+using namespace std;
+
+/// Comparison functor which orders PostList* by descending docid.
+struct ComparePostListDocidDescending {
+    /// Order by descending get_docid().
+    bool operator()(const PostList *a, const PostList *b) const {
+	return a->get_docid() > b->get_docid();
+    }
+};
+
+MultiOrPostList::~MultiOrPostList()
+{
+    if (plist) {
+	for (size_t i = 0; i < n_kids; ++i) {
+	    delete plist[i];
+	}
+	delete [] plist;
+    }
+}
+
+void
+MultiOrPostList::sift_down(size_t i)
+{
+    PostList * pl = plist[i];
+    Xapian::docid pl_did = pl->get_docid();
+    while (true) {
+	size_t child = 2 * i + 1;
+	if (child >= n_kids) break;
+	Xapian::docid child_did = plist[child]->get_docid();
+	if (child + 1 < n_kids) {
+	    Xapian::docid other_did = plist[child + 1]->get_docid();
+	    if (other_did < child_did) {
+		++child;
+		child_did = other_did;
+	    }
+	}
+	if (pl_did <= child_did) break;
+	plist[i] = plist[child];
+	i = child;
+    }
+    plist[i] = pl;
+}
+
+void
+MultiOrPostList::erase_top()
+{
+    delete plist[0];
+    if (--n_kids) {
+	plist[0] = plist[n_kids];
+	sift_down(0);
+    }
+    matcher->recalc_maxweight();
+}
+
+void
+MultiOrPostList::next_top(double w_min)
+{
+    next_handling_prune(plist[0], kid_w_min(0, w_min), matcher);
+    if (plist[0]->at_end()) {
+	erase_top();
+    } else {
+	sift_down(0);
+    }
+}
+
+void
+MultiOrPostList::skip_to_top(Xapian::docid did_min, double w_min)
+{
+    skip_to_handling_prune(plist[0], did_min, kid_w_min(0, w_min), matcher);
+    if (plist[0]->at_end()) {
+	erase_top();
+    } else {
+	sift_down(0);
+    }
+}
+
+void
+MultiOrPostList::start(Xapian::docid did_min, double w_min)
+{
+    size_t i = 0;
+    while (i < n_kids) {
+	double kid_min = kid_w_min(i, w_min);
+	if (did_min == 0) {
+	    next_handling_prune(plist[i], kid_min, matcher);
+	} else {
+	    skip_to_handling_prune(plist[i], did_min, kid_min, matcher);
+	}
+	if (plist[i]->at_end()) {
+	    delete plist[i];
+	    plist[i] = plist[--n_kids];
+	    matcher->recalc_maxweight();
+	    continue;
+	}
+	++i;
+    }
+    make_heap(plist, plist + n_kids, ComparePostListDocidDescending());
+}
+
+void
+MultiOrPostList::init_decayed(bool started)
+{
+    double max_big = 0;
+    size_t big = 0;
+    max_total = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	double w = plist[i]->get_maxweight();
+	max_total += w;
+	if (w > max_big) {
+	    max_big = w;
+	    big = i;
+	}
+    }
+    max_others = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	if (i != big) max_others += plist[i]->get_maxweight();
+    }
+
+    if (started) {
+	make_heap(plist, plist + n_kids, ComparePostListDocidDescending());
+	did = plist[0]->get_docid();
+    }
+}
+
+PostList *
+MultiOrPostList::update_did()
+{
+    if (n_kids == 0) {
+	// We've reached the end of all posting lists.
+	did = 0;
+	return NULL;
+    }
+
+    if (n_kids == 1) {
+	n_kids = 0;
+	return plist[0];
+    }
+
+    did = plist[0]->get_docid();
+    return NULL;
+}
+
+AndMaybePostList *
+MultiOrPostList::decay(Xapian::docid & lhead, Xapian::docid & rhead)
+{
+    // Put the sub-postlist with the greatest maxweight at the end, and
+    // combine all the others into the right branch of the AND_MAYBE.
+    size_t big = 0;
+    double max_big = plist[0]->get_maxweight();
+    for (size_t i = 1; i < n_kids; ++i) {
+	double w = plist[i]->get_maxweight();
+	if (w > max_big) {
+	    max_big = w;
+	    big = i;
+	}
+    }
+    swap(plist[big], plist[n_kids - 1]);
+
+    bool started = (did != 0);
+    PostList * l = plist[n_kids - 1];
+    PostList * r;
+    MultiOrPostList * r_or = NULL;
+    if (n_kids == 2) {
+	r = plist[0];
+    } else {
+	r_or = new MultiOrPostList(plist, plist + n_kids - 1, matcher, db_size);
+	r_or->init_decayed(started);
+	r = r_or;
+    }
+
+    lhead = started ? l->get_docid() : 0;
+    rhead = started ? r->get_docid() : 0;
+
+    AndMaybePostList * ret;
+    try {
+	ret = new AndMaybePostList(l, r, matcher, db_size, lhead, rhead);
+    } catch (...) {
+	if (r_or) {
+	    // We still own the sub-postlists.
+	    r_or->n_kids = 0;
+	    delete r_or;
+	}
+	throw;
+    }
+    n_kids = 0;
+    return ret;
+}
+
+Xapian::doccount
+MultiOrPostList::get_termfreq_min() const
+{
+    // The OR matches at least as many documents as any of the sub-postlists.
+    Xapian::doccount result = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	Xapian::doccount tf_min = plist[i]->get_termfreq_min();
+	if (tf_min > result)
+	    result = tf_min;
+    }
+    return result;
+}
+
+Xapian::doccount
+MultiOrPostList::get_termfreq_max() const
+{
+    // Maximum is if all sub-postlists are disjoint.
+    Xapian::doccount result = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	Xapian::doccount old_result = result;
+	result += plist[i]->get_termfreq_max();
+	// Catch overflowing the type too.
+	if (result < old_result || result >= db_size)
+	    return db_size;
+    }
+    return result;
+}
+
+Xapian::doccount
+MultiOrPostList::get_termfreq_est() const
+{
+    // Sub-postlists are deleted as they run out, so there may be none left.
+    if (rare(db_size == 0 || n_kids == 0))
+	return 0;
+    // We calculate the estimate assuming independence.  The simplest
+    // way to calculate this seems to be a series of (n_kids - 1) pairwise
+    // calculations, which gives the same answer regardless of the order.
+    double scale = 1.0 / db_size;
+    double P_est = plist[0]->get_termfreq_est() * scale;
+    for (size_t i = 1; i < n_kids; ++i) {
+	double P_i = plist[i]->get_termfreq_est() * scale;
+	P_est += P_i - P_est * P_i;
+    }
+    return static_cast<Xapian::doccount>(P_est * db_size + 0.5);
+}
+
+TermFreqs
+MultiOrPostList::get_termfreq_est_using_stats(
+	const Xapian::Weight::Internal & stats) const
+{
+    LOGCALL(MATCH, TermFreqs, "MultiOrPostList::get_termfreq_est_using_stats", stats);
+    // Sub-postlists are deleted as they run out, so there may be none left.
+    if (rare(n_kids == 0))
+	RETURN(TermFreqs());
+    // We calculate the estimate assuming independence.  The simplest
+    // way to calculate this seems to be a series of (n_kids - 1) pairwise
+    // calculations, which gives the same answer regardless of the order.
+    TermFreqs freqs(plist[0]->get_termfreq_est_using_stats(stats));
+
+    // Our caller should have ensured this.
+    Assert(stats.collection_size);
+    double scale = 1.0 / stats.collection_size;
+    double P_est = freqs.termfreq * scale;
+    double Pr_est = 0;
+    if (stats.rset_size != 0)
+	Pr_est = double(freqs.reltermfreq) / stats.rset_size;
+
+    for (size_t i = 1; i < n_kids; ++i) {
+	freqs = plist[i]->get_termfreq_est_using_stats(stats);
+	double P_i = freqs.termfreq * scale;
+	P_est += P_i - P_est * P_i;
+	// If the rset is empty, Pr_est should be 0 already, so leave
+	// it alone.
+	if (stats.rset_size != 0) {
+	    double Pr_i = double(freqs.reltermfreq) / stats.rset_size;
+	    Pr_est += Pr_i - Pr_est * Pr_i;
+	}
+    }
+    RETURN(TermFreqs(Xapian::doccount(P_est * stats.collection_size + 0.5),
+		     Xapian::doccount(Pr_est * stats.rset_size + 0.5)));
+}
+
+double
+MultiOrPostList::get_maxweight() const
+{
+    LOGCALL(MATCH, double, "MultiOrPostList::get_maxweight", NO_ARGS);
+    RETURN(max_total);
+}
+
+Xapian::docid
+MultiOrPostList::get_docid() const
+{
+    return did;
+}
+
+Xapian::termcount
+MultiOrPostList::get_doclength() const
+{
+    Assert(did);
+    // All the sub-postlists at the current docid give the same answer, and
+    // the one at the top of the heap is always at the current docid.
+    return plist[0]->get_doclength();
+}
+
+double
+MultiOrPostList::get_weight_from(size_t i) const
+{
+    // The sub-postlists at the current docid form a subtree of the heap
+    // rooted at the top, so we only need to visit those and their children.
+    double result = plist[i]->get_weight();
+    size_t child = 2 * i + 1;
+    if (child < n_kids && plist[child]->get_docid() == did)
+	result += get_weight_from(child);
+    if (++child < n_kids && plist[child]->get_docid() == did)
+	result += get_weight_from(child);
+    return result;
+}
+
+double
+MultiOrPostList::get_weight() const
+{
+    Assert(did);
+    return get_weight_from(0);
+}
+
+bool
+MultiOrPostList::at_end() const
+{
+    return (did == 0);
+}
+
+double
+MultiOrPostList::recalc_maxweight()
+{
+    LOGCALL(MATCH, double, "MultiOrPostList::recalc_maxweight", NO_ARGS);
+    double max_big = 0;
+    size_t big = 0;
+    max_total = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	double new_max = plist[i]->recalc_maxweight();
+	max_total += new_max;
+	if (new_max > max_big) {
+	    max_big = new_max;
+	    big = i;
+	}
+    }
+    // Sum the others separately rather than subtracting max_big from
+    // max_total so rounding can't make us decay too early.
+    max_others = 0;
+    for (size_t i = 0; i < n_kids; ++i) {
+	if (i != big) max_others += plist[i]->get_maxweight();
+    }
+    RETURN(max_total);
+}
+
+PostList *
+MultiOrPostList::next(double w_min)
+{
+    LOGCALL(MATCH, PostList *, "MultiOrPostList::next", w_min);
+    if (w_min > max_others) {
+	// One of the sub-postlists must match, so we can replace the OR with
+	// an AND_MAYBE.
+	LOGLINE(MATCH, "OR -> AND MAYBE");
+	Xapian::docid lhead, rhead;
+	AndMaybePostList * ret2 = decay(lhead, rhead);
+	PostList * ret = ret2;
+	// Advance the AndMaybePostList unless the old RHS postlist was
+	// already ahead of the current docid.
+	if (lhead <= rhead) {
+	    next_handling_prune(ret, w_min, matcher);
+	} else {
+	    PostList * res = ret2->sync_rhs(w_min);
+	    if (res) {
+		delete ret;
+		ret = res;
+		matcher->recalc_maxweight();
+	    }
+	}
+	RETURN(ret);
+    }
+
+    if (did == 0) {
+	start(0, w_min);
+    } else {
+	while (n_kids && plist[0]->get_docid() <= did) {
+	    next_top(w_min);
+	}
+    }
+    RETURN(update_did());
+}
+
+PostList *
+MultiOrPostList::skip_to(Xapian::docid did_min, double w_min)
+{
+    LOGCALL(MATCH, PostList *, "MultiOrPostList::skip_to", did_min | w_min);
+    if (w_min > max_others) {
+	// One of the sub-postlists must match, so we can replace the OR with
+	// an AND_MAYBE.
+	LOGLINE(MATCH, "OR -> AND MAYBE (in skip_to)");
+	Xapian::docid lhead, rhead;
+	AndMaybePostList * ret2 = decay(lhead, rhead);
+	PostList * ret = ret2;
+	if (lhead) {
+	    PostList * res = ret2->sync_rhs(w_min);
+	    if (res) {
+		delete ret;
+		ret = res;
+		matcher->recalc_maxweight();
+	    }
+	    did_min = max(did_min, lhead);
+	}
+	skip_to_handling_prune(ret, did_min, w_min, matcher);
+	RETURN(ret);
+    }
+
+    if (did == 0) {
+	start(did_min, w_min);
+    } else {
+	if (did_min <= did)
+	    RETURN(NULL);
+	while (n_kids && plist[0]->get_docid() < did_min) {
+	    skip_to_top(did_min, w_min);
+	}
+    }
+    RETURN(update_did());
+}
+
+string
+MultiOrPostList::get_description() const
+{
+    string desc("(");
+    for (size_t i = 0; i < n_kids; ++i) {
+	if (i) desc += " OR ";
+	desc += plist[i]->get_description();
+    }
+    desc += ')';
+    return desc;
+}
+
+Xapian::termcount
+MultiOrPostList::get_wdf_from(size_t i) const
+{
+    Xapian::termcount result = plist[i]->get_wdf();
+    size_t child = 2 * i + 1;
+    if (child < n_kids && plist[child]->get_docid() == did)
+	result += get_wdf_from(child);
+    if (++child < n_kids && plist[child]->get_docid() == did)
+	result += get_wdf_from(child);
+    return result;
+}
+
+Xapian::termcount
+MultiOrPostList::get_wdf() const
+{
+    Assert(did);
+    return get_wdf_from(0);
+}
+
+Xapian::termcount
+MultiOrPostList::count_matching_subqs_from(size_t i) const
+{
+    Xapian::termcount result = plist[i]->count_matching_subqs();
+    size_t child = 2 * i + 1;
+    if (child < n_kids && plist[child]->get_docid() == did)
+	result += count_matching_subqs_from(child);
+    if (++child < n_kids && plist[child]->get_docid() == did)
+	result += count_matching_subqs_from(child);
+    return result;
+}
+
+Xapian::termcount
+MultiOrPostList::count_matching_subqs() const
+{
+    Assert(did);
+    return count_matching_subqs_from(0);
+}
@@ -0,0 +1,179 @@
+/** @file multiorpostlist.h
+ * @brief N-way OR postlist
+ */
+/* Copyright (C) 2026 agent
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef XAPIAN_INCLUDED_MULTIORPOSTLIST_H
+#define XAPIAN_INCLUDED_MULTIORPOSTLIST_H
+
+#include "multimatch.h"
+#include "api/postlist.h"
+#include <algorithm>
+
+class AndMaybePostList;
+class MultiMatch;
+
+/** N-way OR postlist.
+ *
+ *  The sub-postlists are kept in a heap ordered by current docid, so
+ *  advancing only touches the sub-postlists at the current docid, and the
+ *  weight of a document is summed in a single loop rather than by recursing
+ *  through a tree of binary OrPostList objects.
+ *
+ *  Like OrPostList, once the minimum weight required means that one of the
+ *  sub-postlists must match, this decays to an AndMaybePostList with that
+ *  sub-postlist on the left and the others on the right.
+ */
+class MultiOrPostList : public PostList {
+    /// Don't allow assignment.
+    void operator=(const MultiOrPostList &);
+
+    /// Don't allow copying.
+    MultiOrPostList(const MultiOrPostList &);
+
+    /// The current docid, or zero if we haven't started or are at_end.
+    Xapian::docid did;
+
+    /// The number of sub-postlists.
+    size_t n_kids;
+
+    /** Array of pointers to sub-postlists.
+     *
+     *  Once we've started, this is a heap with the sub-postlist with the
+     *  lowest current docid at the top.
+     */
+    PostList ** plist;
+
+    /// Total maximum weight the OR could possibly return.
+    double max_total;
+
+    /** Total maximum weight without the sub-postlist with the greatest
+     *  maximum weight.
+     *
+     *  If w_min exceeds this, we can decay to an AndMaybePostList.
+     */
+    double max_others;
+
+    /// The number of documents in the database.
+    Xapian::doccount db_size;
+
+    /// Pointer to the matcher object, so we can report pruning.
+    MultiMatch *matcher;
+
+    /// Restore the heap property below position i.
+    void sift_down(size_t i);
+
+    /// Erase the sub-postlist at the top of the heap.
+    void erase_top();
+
+    /// Advance the sub-postlist at the top of the heap.
+    void next_top(double w_min);
+
+    /// Advance the sub-postlist at the top of the heap to did_min or later.
+    void skip_to_top(Xapian::docid did_min, double w_min);
+
+    /** Set up the maxweights (and the heap if @a started is true) for a
+     *  MultiOrPostList created by decay().
+     */
+    void init_decayed(bool started);
+
+    /// Start all sub-postlists at did_min (or 0 to call next()).
+    void start(Xapian::docid did_min, double w_min);
+
+    /** Update did from the top of the heap after advancing.
+     *
+     *  If only one sub-postlist is left, it is returned so our caller can
+     *  replace us with it.
+     */
+    PostList * update_did();
+
+    /// Minimum weight which the sub-postlist at position i needs to return.
+    double kid_w_min(size_t i, double w_min) const {
+	return w_min - (max_total - plist[i]->get_maxweight());
+    }
+
+    /** Decay to an AndMaybePostList.
+     *
+     *  Returns the new AndMaybePostList, which has taken ownership of all the
+     *  sub-postlists, and sets @a lhead and @a rhead to the current docids of
+     *  its branches.
+     */
+    AndMaybePostList * decay(Xapian::docid & lhead, Xapian::docid & rhead);
+
+    double get_weight_from(size_t i) const;
+
+    Xapian::termcount get_wdf_from(size_t i) const;
+
+    Xapian::termcount count_matching_subqs_from(size_t i) const;
+
+  public:
+    /** Construct from 2 random-access iterators to a container of PostList*,
+     *  a pointer to the matcher, and the document collection size.
+     */
+    template <class RandomItor>
+    MultiOrPostList(RandomItor pl_begin, RandomItor pl_end,
+		    MultiMatch * matcher_, Xapian::doccount db_size_)
+	: did(0), n_kids(pl_end - pl_begin), plist(NULL),
+	  max_total(0), max_others(0), db_size(db_size_), matcher(matcher_)
+    {
+	plist = new PostList * [n_kids];
+	std::copy(pl_begin, pl_end, plist);
+    }
+
+    ~MultiOrPostList();
+
+    Xapian::doccount get_termfreq_min() const;
+
+    Xapian::doccount get_termfreq_max() const;
+
+    Xapian::doccount get_termfreq_est() const;
+
+    TermFreqs get_termfreq_est_using_stats(
+	const Xapian::Weight::Internal & stats) const;
+
+    double get_maxweight() const;
+
+    Xapian::docid get_docid() const;
+
+    Xapian::termcount get_doclength() const;
+
+    double get_weight() const;
+
+    bool at_end() const;
+
+    double recalc_maxweight();
+
+    Internal *next(double w_min);
+
+    Internal *skip_to(Xapian::docid, double w_min);
+
+    std::string get_description() const;
+
+    /** get_wdf() for MultiOrPostlists returns the sum of the wdfs of the
+     *  sub postlists which match the current docid.
+     *
+     *  The wdf isn't really meaningful in many situations, but if the lists
+     *  are being combined as a synonym we want the sum of the wdfs, so we do
+     *  that in general.
+     */
+    Xapian::termcount get_wdf() const;
+
+    Xapian::termcount count_matching_subqs() const;
+};
+
+#endif // XAPIAN_INCLUDED_MULTIORPOSTLIST_H
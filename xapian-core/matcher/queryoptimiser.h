@@ -48,6 +48,17 @@ class QueryOptimiser {
      */
     Xapian::termcount total_subqs;
 
+    /** The most recently opened leaf postlist.
+     *
+     *  This is used to open the next term's postlist more cheaply, since
+     *  queries often use the same term several times, or terms which are
+     *  close together in the term ordering.
+     */
+    LeafPostList * hint;
+
+    /// Whether we own hint, which happens if it is dropped from the tree.
+    bool hint_owned;
+
   public:
     const Xapian::Database::Internal & db;
 
@@ -59,8 +70,13 @@ class QueryOptimiser {
 		   LocalSubMatch & localsubmatch_,
 		   MultiMatch * matcher_)
 	: localsubmatch(localsubmatch_), total_subqs(0),
+	  hint(0), hint_owned(false),
 	  db(db_), db_size(db.get_doccount()), matcher(matcher_) { }
 
+    ~QueryOptimiser() {
+	if (hint_owned) delete hint;
+    }
+
     void inc_total_subqs() { ++total_subqs; }
 
     Xapian::termcount get_total_subqs() const { return total_subqs; }
@@ -74,12 +90,38 @@ class QueryOptimiser {
     }
 
     LeafPostList * open_post_list(const std::string& term, double max_part) {
-	return localsubmatch.open_post_list(term, max_part);
+	LeafPostList * pl = localsubmatch.open_post_list(term, max_part, hint);
+	if (hint_owned) {
+	    delete hint;
+	    hint_owned = false;
+	}
+	hint = pl;
+	return pl;
+    }
+
+    /** Delete a postlist which is being dropped from the tree being built.
+     *
+     *  If it's the hint postlist, we keep it around so it can still be used
+     *  as a hint.
+     */
+    void destroy_postlist(PostList * pl) {
+	if (pl == static_cast<PostList *>(hint)) {
+	    hint_owned = true;
+	    return;
+	}
+	// The hint might be part of the subtree pl, so stop using it.
+	if (!hint_owned) hint = 0;
+	delete pl;
     }
 
     PostList * make_synonym_postlist(PostList * pl, double factor) {
 	return localsubmatch.make_synonym_postlist(pl, matcher, factor);
     }
+
+    const std::vector<std::string> *
+    get_wildcard_expansion(const Xapian::Internal::QueryWildcard * wildcard) const {
+	return localsubmatch.get_wildcard_expansion(wildcard);
+    }
 };
 
 #endif // XAPIAN_INCLUDED_QUERYOPTIMISER_H
@@ -25,17 +25,30 @@
 
 #include "debuglog.h"
 #include "msetpostlist.h"
+#include "omassert.h"
 #include "backends/remote/remote-database.h"
 #include "weight/weightinternal.h"
 
+#include <algorithm>
+
+using namespace std;
+
+/// Never ask for a first batch of fewer results than this.
+const Xapian::doccount MIN_BATCH_SIZE = 20;
+
 RemoteSubMatch::RemoteSubMatch(RemoteDatabase *db_,
 			       bool decreasing_relevance_,
-			       const vector<Xapian::MatchSpy *> & matchspies_)
+			       const vector<Xapian::MatchSpy *> & matchspies_,
+			       Xapian::doccount batch_subdbs_)
 	: db(db_),
 	  decreasing_relevance(decreasing_relevance_),
-	  matchspies(matchspies_)
+	  matchspies(matchspies_),
+	  batch_subdbs(batch_subdbs_),
+	  wanted(0),
+	  requested(0)
 {
-    LOGCALL_CTOR(MATCH, "RemoteSubMatch", db_ | decreasing_relevance_ | matchspies_);
+    LOGCALL_CTOR(MATCH, "RemoteSubMatch", db_ | decreasing_relevance_ | matchspies_ | batch_subdbs_);
+    Assert(batch_subdbs == 0 || decreasing_relevance);
 }
 
 bool
@@ -56,7 +69,41 @@ RemoteSubMatch::start_match(Xapian::doccount first,
 			    const Xapian::Weight::Internal & total_stats)
 {
     LOGCALL_VOID(MATCH, "RemoteSubMatch::start_match", first | maxitems | check_at_least | total_stats);
-    db->send_global_stats(first, maxitems, check_at_least, total_stats);
+    wanted = maxitems;
+    requested = maxitems;
+    if (batch_subdbs > 1) {
+	// Ask for twice our share of the results to start with, which should
+	// often be enough.
+	Xapian::doccount batch = maxitems / batch_subdbs * 2;
+	requested = min(requested, max(batch, MIN_BATCH_SIZE));
+    }
+    db->send_global_stats(first, requested, check_at_least, total_stats);
+}
+
+bool
+RemoteSubMatch::get_more(Xapian::MSet::Internal & mset_internal, double w_min)
+{
+    LOGCALL(MATCH, bool, "RemoteSubMatch::get_more", Literal("mset_internal") | w_min);
+    vector<Xapian::Internal::MSetItem> & items = mset_internal.items;
+    // If the server didn't return as many results as we asked for, or we've
+    // already asked for all the local match wants, there aren't any more.
+    if (items.size() < requested || requested >= wanted)
+	RETURN(false);
+    // The results are in decreasing weight order, so if the last one doesn't
+    // have enough weight, none of the rest will either.
+    if (!items.empty() && items.back().wt < w_min)
+	RETURN(false);
+
+    // Double the number of results we've asked for each time.
+    Xapian::doccount batch = min(requested, wanted - requested);
+    db->send_get_more(requested, batch, w_min);
+    requested += batch;
+
+    Xapian::MSet mset;
+    db->get_mset(mset, matchspies);
+    const vector<Xapian::Internal::MSetItem> & more = mset.internal->items;
+    items.insert(items.end(), more.begin(), more.end());
+    RETURN(!more.empty());
 }
 
 PostList *
@@ -72,5 +119,6 @@ RemoteSubMatch::get_postlist_and_term_info(MultiMatch *,
     // For remote databases we report percent_factor rather than counting the
     // number of subqueries.
     (void)total_subqs_ptr;
-    return new MSetPostList(mset, decreasing_relevance);
+    return new MSetPostList(mset, decreasing_relevance,
+			    batch_subdbs ? this : NULL);
 }
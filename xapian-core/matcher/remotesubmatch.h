@@ -53,11 +53,31 @@ class RemoteSubMatch : public SubMatch {
     /// The matchspies to use.
     const vector<Xapian::MatchSpy *> & matchspies;
 
+    /** The number of sub-databases in the match if fetching results in
+     *  batches, or 0 to fetch them all at once.
+     */
+    Xapian::doccount batch_subdbs;
+
+    /// The number of results the local match wants from us.
+    Xapian::doccount wanted;
+
+    /// The number of results we've asked the remote server for so far.
+    Xapian::doccount requested;
+
   public:
-    /// Constructor.
+    /** Constructor.
+     *
+     *  @param batch_subdbs_	If non-zero, initially only ask for about
+     *				twice our share of the results, assuming
+     *				they're spread across this many
+     *				sub-databases, and fetch more in batches if
+     *				they're needed.  This requires that the
+     *				results are in decreasing relevance order.
+     */
     RemoteSubMatch(RemoteDatabase *db_,
 		   bool decreasing_relevance_,
-		   const vector<Xapian::MatchSpy *> & matchspies);
+		   const vector<Xapian::MatchSpy *> & matchspies,
+		   Xapian::doccount batch_subdbs_ = 0);
 
     /// Fetch and collate statistics.
     bool prepare_match(bool nowait, Xapian::Weight::Internal & total_stats);
@@ -77,6 +97,16 @@ class RemoteSubMatch : public SubMatch {
     /// Get percentage factor - only valid after get_postlist_and_term_info().
     double get_percent_factor() const { return percent_factor; }
 
+    /** Append the next batch of results to @a mset_internal.
+     *
+     *  @param mset_internal	The results we've got so far.
+     *  @param w_min		The minimum weight a result needs to make it
+     *				into the local match's MSet.
+     *
+     *  @return	true if any results were added.
+     */
+    bool get_more(Xapian::MSet::Internal & mset_internal, double w_min);
+
     /// Short-cut for single remote match.
     void get_mset(Xapian::MSet & mset) { db->get_mset(mset, matchspies); }
 };
@@ -28,10 +28,14 @@
 #include "safefcntl.h"
 #include "safesysselect.h"
 #include "safeunistd.h"
+#ifndef __WIN32__
+# include <sys/uio.h>
+#endif
 
 #include <algorithm>
 #include <string>
 
+#include "compression_stream.h"
 #include "debuglog.h"
 #include "fd.h"
 #include "filetests.h"
@@ -46,6 +50,12 @@ using namespace std;
 
 #define CHUNKSIZE 4096
 
+/// Don't try to compress messages smaller than this.
+#define COMPRESS_MIN 4096
+
+/// Or messages too large for zlib to handle in one go.
+#define COMPRESS_MAX 0xffffffffu
+
 XAPIAN_NORETURN(static void throw_database_closed());
 static void
 throw_database_closed()
@@ -65,7 +75,8 @@ update_overlapped_offset(WSAOVERLAPPED & overlapped, DWORD n)
 
 RemoteConnection::RemoteConnection(int fdin_, int fdout_,
 				   const string & context_)
-    : fdin(fdin_), fdout(fdout_), context(context_)
+    : fdin(fdin_), fdout(fdout_), compress_messages(false), comp_stream(NULL),
+      context(context_)
 {
 #ifdef __WIN32__
     memset(&overlapped, 0, sizeof(overlapped));
@@ -77,13 +88,14 @@ RemoteConnection::RemoteConnection(int fdin_, int fdout_,
 #endif
 }
 
-#ifdef __WIN32__
 RemoteConnection::~RemoteConnection()
 {
+    delete comp_stream;
+#ifdef __WIN32__
     if (overlapped.hEvent)
 	CloseHandle(overlapped.hEvent);
-}
 #endif
+}
 
 void
 RemoteConnection::read_at_least(size_t min_len, double end_time)
@@ -215,16 +227,47 @@ RemoteConnection::send_message(char type, const string &message,
 
     string header;
     header += type;
+
+    if (compress_messages &&
+	message.size() >= COMPRESS_MIN &&
+	message.size() <= COMPRESS_MAX) {
+	if (!comp_stream)
+	    comp_stream = new CompressionStream(Z_DEFAULT_STRATEGY);
+	comp_stream->lazy_alloc_deflate_zstream();
+	comp_stream->compress(message, message.size() - 1);
+	if (comp_stream->zerr == Z_STREAM_END) {
+	    // The compressed data fitted in one byte less than the input, so
+	    // send that instead, straight from the zlib output buffer.
+	    size_t comp_len = comp_stream->deflate_zstream->total_out;
+	    string uncomp_len = encode_length(message.size());
+	    header[0] |= char(MESSAGE_COMPRESSED);
+	    header += encode_length(uncomp_len.size() + comp_len);
+	    header += uncomp_len;
+	    write_pieces(header.data(), header.size(),
+			 reinterpret_cast<const char *>(comp_stream->out),
+			 comp_len, end_time);
+	    return;
+	}
+    }
+
     header += encode_length(message.size());
+    write_pieces(header.data(), header.size(),
+		 message.data(), message.size(), end_time);
+}
+
+void
+RemoteConnection::write_pieces(const char * p1, size_t n1,
+			       const char * p2, size_t n2,
+			       double end_time)
+{
+    LOGCALL_VOID(REMOTE, "RemoteConnection::write_pieces", (void*)p1 | n1 | (void*)p2 | n2 | end_time);
 
 #ifdef __WIN32__
     HANDLE hout = fd_to_handle(fdout);
-    const string * str = &header;
 
-    size_t count = 0;
     while (true) {
 	DWORD n;
-	BOOL ok = WriteFile(hout, str->data() + count, str->size() - count, &n, &overlapped);
+	BOOL ok = WriteFile(hout, p1, n1, &n, &overlapped);
 	if (!ok) {
 	    int errcode = GetLastError();
 	    if (errcode != ERROR_IO_PENDING)
@@ -242,15 +285,17 @@ RemoteConnection::send_message(char type, const string &message,
 					   context, -(int)GetLastError());
 	}
 
-	count += n;
+	p1 += n;
+	n1 -= n;
 
 	// We must update the offset in the OVERLAPPED structure manually.
 	update_overlapped_offset(overlapped, n);
 
-	if (count == str->size()) {
-	    if (str == &message || message.empty()) return;
-	    str = &message;
-	    count = 0;
+	if (n1 == 0) {
+	    if (n2 == 0) return;
+	    p1 = p2;
+	    n1 = n2;
+	    n2 = 0;
 	}
     }
 #else
@@ -260,22 +305,32 @@ RemoteConnection::send_message(char type, const string &message,
 				   context, errno);
     }
 
-    const string * str = &header;
+    // Use writev() so that the header and the message data usually go in a
+    // single system call (and a single packet for a small message) without
+    // having to copy them into one buffer first.
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<char *>(p1);
+    iov[0].iov_len = n1;
+    iov[1].iov_base = const_cast<char *>(p2);
+    iov[1].iov_len = n2;
+    struct iovec * iov_ptr = iov;
+    int iov_count = (n2 ? 2 : 1);
 
     fd_set fdset;
-    size_t count = 0;
     while (true) {
 	// We've set write to non-blocking, so just try writing as there
 	// will usually be space.
-	ssize_t n = write(fdout, str->data() + count, str->size() - count);
+	ssize_t n = writev(fdout, iov_ptr, iov_count);
 
 	if (n >= 0) {
-	    count += n;
-	    if (count == str->size()) {
-		if (str == &message || message.empty()) return;
-		str = &message;
-		count = 0;
+	    size_t count = n;
+	    while (count >= iov_ptr->iov_len) {
+		count -= iov_ptr->iov_len;
+		++iov_ptr;
+		if (--iov_count == 0) return;
 	    }
+	    iov_ptr->iov_base = static_cast<char *>(iov_ptr->iov_base) + count;
+	    iov_ptr->iov_len -= count;
 	    continue;
 	}
 
@@ -460,7 +515,7 @@ RemoteConnection::sniff_next_message_type(double end_time)
 	throw_database_closed();
 
     read_at_least(1, end_time);
-    char type = buffer[0];
+    char type = buffer[0] & ~char(MESSAGE_COMPRESSED);
     RETURN(type);
 }
 
@@ -474,34 +529,86 @@ RemoteConnection::get_message(string &result, double end_time)
     read_at_least(2, end_time);
     size_t len = static_cast<unsigned char>(buffer[1]);
     read_at_least(len + 2, end_time);
+    char type = buffer[0];
     if (len != 0xff) {
 	result.assign(buffer.data() + 2, len);
-	char type = buffer[0];
 	buffer.erase(0, len + 2);
-	RETURN(type);
+    } else {
+	len = 0;
+	string::const_iterator i = buffer.begin() + 2;
+	unsigned char ch;
+	int shift = 0;
+	do {
+	    if (i == buffer.end() || shift > 28) {
+		// Something is very wrong...
+		throw Xapian::NetworkError("Insane message length specified!");
+	    }
+	    ch = *i++;
+	    len |= size_t(ch & 0x7f) << shift;
+	    shift += 7;
+	} while ((ch & 0x80) == 0);
+	len += 255;
+	size_t header_len = (i - buffer.begin());
+	read_at_least(header_len + len, end_time);
+	result.assign(buffer.data() + header_len, len);
+	buffer.erase(0, header_len + len);
+    }
+    if (type & char(MESSAGE_COMPRESSED)) {
+	decompress_message(result);
+	type &= ~char(MESSAGE_COMPRESSED);
     }
-    len = 0;
-    string::const_iterator i = buffer.begin() + 2;
-    unsigned char ch;
-    int shift = 0;
-    do {
-	if (i == buffer.end() || shift > 28) {
-	    // Something is very wrong...
-	    throw Xapian::NetworkError("Insane message length specified!");
-	}
-	ch = *i++;
-	len |= size_t(ch & 0x7f) << shift;
-	shift += 7;
-    } while ((ch & 0x80) == 0);
-    len += 255;
-    size_t header_len = (i - buffer.begin());
-    read_at_least(header_len + len, end_time);
-    result.assign(buffer.data() + header_len, len);
-    char type = buffer[0];
-    buffer.erase(0, header_len + len);
     RETURN(type);
 }
 
+void
+RemoteConnection::decompress_message(string & message)
+{
+    LOGCALL_VOID(REMOTE, "RemoteConnection::decompress_message", message.size());
+    const char * p = message.data();
+    const char * p_end = p + message.size();
+    size_t uncomp_len = decode_length(&p, p_end, false);
+    if (uncomp_len == 0 || uncomp_len > COMPRESS_MAX)
+	throw Xapian::NetworkError("Bad compressed message received", context);
+
+    if (!comp_stream)
+	comp_stream = new CompressionStream(Z_DEFAULT_STRATEGY);
+    comp_stream->lazy_alloc_inflate_zstream();
+
+    // Don't trust uncomp_len to size the buffer, as the other end could
+    // send a small message claiming to expand to several gigabytes.  Instead
+    // inflate in pieces, only growing the buffer as output is produced, and
+    // stop if there's more output than we were told to expect.
+    string uncompressed;
+    uncompressed.reserve(min(uncomp_len, size_t(p_end - p) * 4));
+    z_stream * zstream = comp_stream->inflate_zstream;
+    zstream->next_in = (Bytef*)const_cast<char *>(p);
+    zstream->avail_in = (uInt)(p_end - p);
+    Bytef buf[8192];
+    int err = Z_OK;
+    while (err == Z_OK) {
+	zstream->next_out = buf;
+	zstream->avail_out = (uInt)sizeof(buf);
+	err = inflate(zstream, Z_NO_FLUSH);
+	size_t n = zstream->next_out - buf;
+	if (n > uncomp_len - uncompressed.size()) {
+	    throw Xapian::NetworkError("Compressed message expanded to more "
+				       "than the specified size", context);
+	}
+	uncompressed.append(reinterpret_cast<const char *>(buf), n);
+	// If the compressed data is truncated, inflate() will eventually
+	// return Z_BUF_ERROR as it can't make progress.
+    }
+    if (err != Z_STREAM_END || uncompressed.size() != uncomp_len) {
+	string msg = "Failed to decompress message";
+	if (zstream->msg) {
+	    msg += ": ";
+	    msg += zstream->msg;
+	}
+	throw Xapian::NetworkError(msg, context);
+    }
+    message.swap(uncompressed);
+}
+
 char
 RemoteConnection::get_message_chunked(double end_time)
 {
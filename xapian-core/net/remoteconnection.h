@@ -26,6 +26,8 @@
 #include "remoteprotocol.h"
 #include "safeunistd.h"
 
+class CompressionStream;
+
 #ifdef __WIN32__
 # include "safewinsock2.h"
 
@@ -119,6 +121,28 @@ class RemoteConnection {
     /// Remaining bytes of message data still to come over fdin for a chunked read.
     off_t chunked_data_left;
 
+    /** Should send_message() compress large messages?
+     *
+     *  Set by enable_compression().
+     */
+    bool compress_messages;
+
+    /// Zlib state used to compress and decompress messages (lazily created).
+    CompressionStream * comp_stream;
+
+    /// Decompress a message which was sent with MESSAGE_COMPRESSED set.
+    void decompress_message(std::string & message);
+
+    /** Write n1 bytes from p1 followed by n2 bytes from p2 to fdout.
+     *
+     *  @param end_time	If this time is reached, then a timeout
+     *			exception will be thrown.  If (end_time == 0.0),
+     *			then keep trying indefinitely.
+     */
+    void write_pieces(const char * p1, size_t n1,
+		      const char * p2, size_t n2,
+		      double end_time);
+
     /** Read until there are at least min_len bytes in buffer.
      *
      *  If for some reason this isn't possible, throws NetworkError.
@@ -157,10 +181,20 @@ class RemoteConnection {
     RemoteConnection(int fdin_, int fdout_,
 		     const std::string & context_ = std::string());
 
-#ifdef __WIN32__
-    /// Destructor
+    /// Destructor.
     ~RemoteConnection();
-#endif
+
+    /** Compress large messages which we send.
+     *
+     *  Only messages of at least a few KB are compressed, and only if that
+     *  makes them smaller.  get_message() decompresses messages whether or
+     *  not this has been called, but the other end must be told it may send
+     *  compressed messages (currently using MSG_COMPRESSION).
+     *
+     *  Messages sent by send_file() are never compressed, and a compressed
+     *  message must be read with get_message().
+     */
+    void enable_compression() { compress_messages = true; }
 
     /** See if there is data available to read.
      *
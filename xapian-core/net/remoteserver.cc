@@ -31,6 +31,7 @@
 
 #include "safeerrno.h"
 #include <signal.h>
+#include <algorithm>
 #include <cstdlib>
 
 #include "autoptr.h"
@@ -182,6 +183,9 @@ RemoteServer::run()
 		0, // MSG_GETMSET - used during a conversation.
 		0, // MSG_SHUTDOWN - handled by get_message().
 		&RemoteServer::msg_openmetadatakeylist,
+		&RemoteServer::msg_compression,
+		&RemoteServer::msg_querymset,
+		0, // MSG_GETMORE - used during a conversation.
 	    };
 
 	    string message;
@@ -327,6 +331,14 @@ RemoteServer::msg_reopen(const string & msg)
     msg_update(msg);
 }
 
+void
+RemoteServer::msg_compression(const string &)
+{
+    // The client can decompress messages, so compress large replies.  No
+    // reply is sent to this message.
+    enable_compression();
+}
+
 void
 RemoteServer::msg_update(const string &)
 {
@@ -369,6 +381,22 @@ struct MatchSpyList {
 
 void
 RemoteServer::msg_query(const string &message_in)
+{
+    run_query(message_in, NULL);
+}
+
+void
+RemoteServer::msg_querymset(const string &message_in)
+{
+    const char *p = message_in.data();
+    const char *p_end = p + message_in.size();
+    size_t len = decode_length(&p, p_end, true);
+    string getmset(p + len, p_end);
+    run_query(string(p, len), &getmset);
+}
+
+void
+RemoteServer::run_query(const string &message_in, const string * getmset)
 {
     const char *p = message_in.c_str();
     const char *p_end = p + message_in.size();
@@ -462,10 +490,15 @@ RemoteServer::msg_query(const string &message_in)
 		     sort_key, sort_by, sort_value_forward, NULL,
 		     local_stats, wt.get(), matchspies.spies, false, false);
 
-    send_message(REPLY_STATS, serialise_stats(local_stats));
-
     string message;
-    get_message(active_timeout, message, MSG_GETMSET);
+    if (getmset) {
+	// The client already had our stats, so it sent the global stats with
+	// the query.
+	message = *getmset;
+    } else {
+	send_message(REPLY_STATS, serialise_stats(local_stats));
+	get_message(active_timeout, message, MSG_GETMSET);
+    }
     p = message.c_str();
     p_end = p + message.size();
 
@@ -482,15 +515,36 @@ RemoteServer::msg_query(const string &message_in)
     Xapian::MSet mset;
     match.get_mset(first, maxitems, check_at_least, mset, total_stats, 0, 0);
 
-    message.resize(0);
-    vector<Xapian::MatchSpy *>::const_iterator i;
-    for (i = matchspies.spies.begin(); i != matchspies.spies.end(); ++i) {
-	string spy_results = (*i)->serialise_results();
-	message += encode_length(spy_results.size());
-	message += spy_results;
+    while (true) {
+	message.resize(0);
+	vector<Xapian::MatchSpy *>::const_iterator i;
+	for (i = matchspies.spies.begin(); i != matchspies.spies.end(); ++i) {
+	    string spy_results = (*i)->serialise_results();
+	    message += encode_length(spy_results.size());
+	    message += spy_results;
+	}
+	message += serialise_mset(mset);
+	send_message(REPLY_RESULTS, message);
+
+	// If the client wants more results for this query, it asks before
+	// sending any other message.
+	double end_time = RealTime::end_time(idle_timeout);
+	if (sniff_next_message_type(end_time) != MSG_GETMORE) break;
+
+	get_message(active_timeout, message, MSG_GETMORE);
+	p = message.c_str();
+	p_end = p + message.size();
+	first = decode_length(&p, p_end, false);
+	maxitems = decode_length(&p, p_end, false);
+	double w_min = unserialise_double(&p, p_end);
+	if (p != p_end) {
+	    throw Xapian::NetworkError("bad message (get more)");
+	}
+	// The client doesn't need any results with less weight than w_min.
+	match.set_weight_cutoff(max(weight_cutoff, w_min));
+	mset = Xapian::MSet();
+	match.get_mset(first, maxitems, maxitems, mset, total_stats, 0, 0);
     }
-    message += serialise_mset(mset);
-    send_message(REPLY_RESULTS, message);
 }
 
 void
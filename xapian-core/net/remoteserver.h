@@ -110,6 +110,17 @@ class XAPIAN_VISIBILITY_DEFAULT RemoteServer : private RemoteConnection {
     // set the query; return the mset
     void msg_query(const std::string & message);
 
+    // run query and send mset, given the global stats
+    void msg_querymset(const std::string & message);
+
+    /** Run a query.
+     *
+     *  @param message	The MSG_QUERY message.
+     *  @param getmset	The MSG_GETMSET message, or NULL to send our stats and
+     *			wait for the client to send it.
+     */
+    void run_query(const std::string & message, const std::string * getmset);
+
     // get termlist
     void msg_termlist(const std::string & message);
 
@@ -128,6 +139,9 @@ class XAPIAN_VISIBILITY_DEFAULT RemoteServer : private RemoteConnection {
     // get updated doccount and avlength
     void msg_update(const std::string &message);
 
+    // compress large replies
+    void msg_compression(const std::string & message);
+
     // commit
     void msg_commit(const std::string & message);
 
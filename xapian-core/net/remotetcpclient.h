@@ -76,7 +76,7 @@ class RemoteTcpClient : SOCKET_INITIALIZER_MIXIN public RemoteDatabase {
 		    double timeout_, double timeout_connect, bool writable)
 	: RemoteDatabase(open_socket(hostname, port, timeout_connect),
 			 timeout_, get_tcpcontext(hostname, port),
-			 writable) { }
+			 writable, true) { }
 
     /** Destructor. */
     ~RemoteTcpClient();
@@ -136,6 +136,24 @@ void
 QueryParser::set_max_wildcard_expansion(Xapian::termcount max)
 {
     internal->max_wildcard_expansion = max;
+    internal->max_wildcard_type = Query::WILDCARD_LIMIT_ERROR;
+}
+
+void
+QueryParser::set_max_wildcard_expansion(Xapian::termcount max,
+				       int max_type)
+{
+    if (rare(max_type < Query::WILDCARD_LIMIT_ERROR ||
+	     max_type > Query::WILDCARD_LIMIT_MOST_FREQUENT))
+	throw Xapian::InvalidArgumentError("Unknown wildcard limit type");
+    internal->max_wildcard_expansion = max;
+    internal->max_wildcard_type = max_type;
+}
+
+void
+QueryParser::set_max_edge_ngram_length(unsigned max_edge_ngram_length)
+{
+    internal->max_edge_ngram_length = max_edge_ngram_length;
 }
 
 Query
@@ -88,6 +88,10 @@ class QueryParser::Internal : public Xapian::Internal::intrusive_base {
 
     Xapian::termcount max_wildcard_expansion;
 
+    int max_wildcard_type;
+
+    unsigned max_edge_ngram_length;
+
     void add_prefix(const string &field, const string &prefix,
 		    filter_type type);
 
@@ -100,7 +104,9 @@ class QueryParser::Internal : public Xapian::Internal::intrusive_base {
 
   public:
     Internal() : stem_action(STEM_SOME), stopper(NULL),
-	default_op(Query::OP_OR), errmsg(NULL), max_wildcard_expansion(0) { }
+	default_op(Query::OP_OR), errmsg(NULL), max_wildcard_expansion(0),
+	max_wildcard_type(Query::WILDCARD_LIMIT_ERROR),
+	max_edge_ngram_length(0) { }
 
     Query parse_query(const string & query_string, unsigned int flags, const string & default_prefix);
 };
@@ -94,6 +94,12 @@ TermGenerator::set_max_word_length(unsigned max_word_length)
     internal->max_word_length = max_word_length;
 }
 
+void
+TermGenerator::set_max_edge_ngram_length(unsigned max_edge_ngram_length)
+{
+    internal->max_edge_ngram_length = max_edge_ngram_length;
+}
+
 void
 TermGenerator::index_text(const Xapian::Utf8Iterator & itor,
 			  Xapian::termcount weight,
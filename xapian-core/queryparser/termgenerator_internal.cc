@@ -26,6 +26,7 @@
 #include <xapian/queryparser.h>
 #include <xapian/unicode.h>
 
+#include "edgengram.h"
 #include "stringutils.h"
 
 #include <limits>
@@ -276,6 +277,21 @@ endofterm:
 	}
 	if ((flags & FLAG_SPELLING) && prefix.empty()) db.add_spelling(term);
 
+	if (max_edge_ngram_length) {
+	    // Add the leading n-grams for QueryParser's FLAG_PARTIAL to use.
+	    // They get the same wdf as the word, so a partial word is weighted
+	    // like the terms a wildcard would expand to, but the backends
+	    // don't count them in the document length.
+	    string ngram(1, EDGE_NGRAM_PREFIX);
+	    ngram += prefix;
+	    unsigned n = 0;
+	    for (Utf8Iterator u(term);
+		 u != Utf8Iterator() && n != max_edge_ngram_length; ++u, ++n) {
+		Unicode::append_utf8(ngram, *u);
+		doc.add_term(ngram, wdf_inc);
+	    }
+	}
+
 	if (strategy == TermGenerator::STEM_NONE ||
 	    !stemmer.internal.get()) continue;
 
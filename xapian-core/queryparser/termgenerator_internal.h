@@ -40,11 +40,13 @@ class TermGenerator::Internal : public Xapian::Internal::intrusive_base {
     termcount termpos;
     TermGenerator::flags flags;
     unsigned max_word_length;
+    unsigned max_edge_ngram_length;
     WritableDatabase db;
 
   public:
     Internal() : strategy(STEM_SOME), stopper(NULL), termpos(0),
-	flags(TermGenerator::flags(0)), max_word_length(64) { }
+	flags(TermGenerator::flags(0)), max_word_length(64),
+	max_edge_ngram_length(0) { }
     void index_text(Utf8Iterator itor,
 		    termcount weight,
 		    const std::string & prefix,
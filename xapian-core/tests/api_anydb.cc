@@ -37,6 +37,9 @@
 #include "apitest.h"
 
 #include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -305,6 +308,72 @@ DEFINE_TESTCASE(multidb5, backend && !multi) {
     return true;
 }
 
+// tests MultiPostList::next() and skip_to() against the sub-databases.
+DEFINE_TESTCASE(multidb6, backend && !multi) {
+    Xapian::Database dbs[3] = {
+	get_database("apitest_simpledata"),
+	get_database("apitest_termorder"),
+	get_database("apitest_simpledata2")
+    };
+    Xapian::Database mydb(dbs[0]);
+    mydb.add_database(dbs[1]);
+    mydb.add_database(dbs[2]);
+
+    const char * terms[] = { "this", "word", "inmemory", "one" };
+    for (size_t t = 0; t != sizeof(terms) / sizeof(terms[0]); ++t) {
+	tout << "Term: " << terms[t] << endl;
+	vector<Xapian::docid> expected;
+	// The wdf and document length for each merged docid, which come from
+	// whichever sub-postlist is at the top of MultiPostList's heap.
+	map<Xapian::docid, pair<Xapian::termcount, Xapian::termcount> > stats;
+	for (Xapian::doccount n = 0; n != 3; ++n) {
+	    Xapian::PostingIterator p;
+	    for (p = dbs[n].postlist_begin(terms[t]);
+		 p != dbs[n].postlist_end(terms[t]); ++p) {
+		Xapian::docid did = (*p - 1) * 3 + n + 1;
+		expected.push_back(did);
+		stats[did] = make_pair(p.get_wdf(), p.get_doclength());
+	    }
+	}
+	sort(expected.begin(), expected.end());
+
+	Xapian::PostingIterator i = mydb.postlist_begin(terms[t]);
+	vector<Xapian::docid>::const_iterator e;
+	for (e = expected.begin(); e != expected.end(); ++e) {
+	    TEST(i != mydb.postlist_end(terms[t]));
+	    TEST_EQUAL(*i, *e);
+	    TEST_EQUAL(i.get_wdf(), stats[*e].first);
+	    TEST_EQUAL(i.get_doclength(), stats[*e].second);
+	    ++i;
+	}
+	TEST(i == mydb.postlist_end(terms[t]));
+
+	// Check skip_to() to every docid, both from the start and onwards from
+	// the previous position.
+	Xapian::docid lastdid = mydb.get_lastdocid();
+	Xapian::PostingIterator j = mydb.postlist_begin(terms[t]);
+	for (Xapian::docid did = 1; did <= lastdid + 1; ++did) {
+	    e = lower_bound(expected.begin(), expected.end(), did);
+	    i = mydb.postlist_begin(terms[t]);
+	    if (i != mydb.postlist_end(terms[t])) i.skip_to(did);
+	    if (j != mydb.postlist_end(terms[t])) j.skip_to(did);
+	    if (e == expected.end()) {
+		TEST(i == mydb.postlist_end(terms[t]));
+		TEST(j == mydb.postlist_end(terms[t]));
+	    } else {
+		TEST(i != mydb.postlist_end(terms[t]));
+		TEST_EQUAL(*i, *e);
+		TEST_EQUAL(i.get_wdf(), stats[*e].first);
+		TEST(j != mydb.postlist_end(terms[t]));
+		TEST_EQUAL(*j, *e);
+		TEST_EQUAL(j.get_doclength(), stats[*e].second);
+	    }
+	}
+    }
+
+    return true;
+}
+
 // tests that when specifying maxitems to get_mset, no more than
 // that are returned.
 DEFINE_TESTCASE(msetmaxitems1, backend) {
@@ -2304,3 +2373,59 @@ DEFINE_TESTCASE(uuid1, backend && !multi) {
 
     return true;
 }
+
+/// Match decider which only accepts documents with an odd docid.
+struct OddDocidMatchDecider : public Xapian::MatchDecider {
+    bool operator()(const Xapian::Document & doc) const {
+	return doc.get_docid() % 2 == 1;
+    }
+};
+
+/// Test the MSet query profiling information.
+DEFINE_TESTCASE(msetprofile1, backend && !remote) {
+    Xapian::Database db = get_database("apitest_simpledata");
+    Xapian::Enquire enquire(db);
+    enquire.set_query(Xapian::Query("this"));
+    Xapian::MSet mset = enquire.get_mset(0, db.get_doccount());
+    TEST_REL(mset.get_setup_time(),>=,0);
+    TEST_REL(mset.get_match_time(),>=,0);
+    // With no cutoffs in effect, every document matching the term should
+    // be considered.
+    TEST_EQUAL(mset.get_candidates_considered(), db.get_termfreq("this"));
+
+    // A match decider or collapsing doesn't change the number of candidates.
+    OddDocidMatchDecider decider;
+    mset = enquire.get_mset(0, db.get_doccount(), NULL, &decider);
+    TEST_REL(mset.size(),<,db.get_termfreq("this"));
+    TEST_EQUAL(mset.get_candidates_considered(), db.get_termfreq("this"));
+
+    enquire.set_collapse_key(1);
+    mset = enquire.get_mset(0, db.get_doccount());
+    TEST_EQUAL(mset.get_candidates_considered(), db.get_termfreq("this"));
+
+    enquire.set_query(Xapian::Query());
+    mset = enquire.get_mset(0, 10);
+    TEST_EQUAL(mset.get_candidates_considered(), 0);
+    TEST_EQUAL(mset.get_match_time(), 0);
+
+    return true;
+}
+
+/// Check the profiling information reported for a remote database.
+DEFINE_TESTCASE(msetprofile2, remote) {
+    Xapian::Database db = get_database("apitest_simpledata");
+    Xapian::Enquire enquire(db);
+    enquire.set_query(Xapian::Query("this"));
+    Xapian::MSet mset = enquire.get_mset(0, db.get_doccount());
+    TEST_REL(mset.get_setup_time(),>=,0);
+    TEST_REL(mset.get_match_time(),>=,0);
+    // The server doesn't report the candidates it considered, so just the
+    // documents it returned are counted.
+    TEST_EQUAL(mset.get_candidates_considered(), mset.size());
+
+    mset = enquire.get_mset(1, 2);
+    TEST_EQUAL(mset.size(), 2);
+    TEST_EQUAL(mset.get_candidates_considered(), 2);
+
+    return true;
+}
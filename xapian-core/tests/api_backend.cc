@@ -36,6 +36,9 @@
 #include "safefcntl.h"
 #include "safesysstat.h"
 #include "safeunistd.h"
+#include <stdlib.h> // For setenv() and unsetenv()
+
+#include <vector>
 
 using namespace std;
 
@@ -106,6 +109,46 @@ DEFINE_TESTCASE(dbstats1, backend) {
     return true;
 }
 
+/// Check brass tracks a wdf upper bound for each term.
+DEFINE_TESTCASE(wdfupperbound1, brass) {
+    Xapian::WritableDatabase db = get_writable_database();
+    Xapian::Document doc;
+    doc.add_term("rare", 2);
+    doc.add_term("common", 1);
+    db.add_document(doc);
+    doc.clear_terms();
+    doc.add_term("common", 3);
+    doc.add_term("big", 40);
+    db.add_document(doc);
+
+    // Check the bounds include changes which haven't been committed.
+    TEST_EQUAL(db.get_wdf_upper_bound("rare"), 2);
+    TEST_EQUAL(db.get_wdf_upper_bound("common"), 3);
+    TEST_EQUAL(db.get_wdf_upper_bound("absent"), 0);
+    db.commit();
+    TEST_EQUAL(db.get_wdf_upper_bound("rare"), 2);
+    TEST_EQUAL(db.get_wdf_upper_bound("common"), 3);
+    TEST_EQUAL(db.get_wdf_upper_bound("big"), 40);
+
+    // Increasing the wdf in an existing postlist must raise the bound.
+    doc.clear_terms();
+    doc.add_term("rare", 7);
+    doc.add_term("common", 1);
+    db.replace_document(1, doc);
+    TEST_EQUAL(db.get_wdf_upper_bound("rare"), 7);
+    db.commit();
+    TEST_EQUAL(db.get_wdf_upper_bound("rare"), 7);
+
+    // Deleting documents may leave the bound loose, but it must still be an
+    // upper bound.
+    db.delete_document(2);
+    db.commit();
+    TEST_REL(db.get_wdf_upper_bound("common"),>=,1);
+    TEST_EQUAL(db.get_wdf_upper_bound("big"), 0);
+
+    return true;
+}
+
 /// Check handling of alldocs on an empty database.
 DEFINE_TESTCASE(alldocspl3, backend) {
     Xapian::Database db = get_database(string());
@@ -697,6 +740,84 @@ DEFINE_TESTCASE(failedreplace2, brass || chert) {
     return true;
 }
 
+#ifdef HAVE_SETENV
+/// Set an environment variable, restoring its previous state on destruction.
+class EnvVarSetter {
+    const char * name;
+
+    bool was_set;
+
+    string old_value;
+
+  public:
+    EnvVarSetter(const char * name_, const char * value) : name(name_) {
+	const char * p = getenv(name);
+	was_set = (p != NULL);
+	if (was_set) old_value = p;
+	setenv(name, value, 1);
+    }
+
+    ~EnvVarSetter() {
+	if (was_set) {
+	    setenv(name, old_value.c_str(), 1);
+	} else {
+	    unsetenv(name);
+	}
+    }
+};
+#endif
+
+/// Test searching brass tables mapped into memory.
+DEFINE_TESTCASE(mmapreadonly1, brass) {
+#ifndef HAVE_SETENV
+    SKIP_TEST("setenv() not available");
+#else
+    Xapian::Database db_plain(get_database("apitest_simpledata"));
+    Xapian::Enquire enq_plain(db_plain);
+    enq_plain.set_query(Xapian::Query(Xapian::Query::OP_OR,
+				      Xapian::Query("this"),
+				      Xapian::Query("paragraph")));
+    Xapian::MSet mset_plain = enq_plain.get_mset(0, 10);
+
+    Xapian::WritableDatabase wdb = get_writable_database("apitest_simpledata");
+    wdb.commit();
+    Xapian::Database db;
+    {
+	EnvVarSetter mmap_readonly("XAPIAN_MMAP_READONLY", "1");
+	db = get_writable_database_as_database();
+    }
+
+    Xapian::Enquire enq(db);
+    enq.set_query(enq_plain.get_query());
+    Xapian::MSet mset = enq.get_mset(0, 10);
+    TEST_EQUAL(mset.size(), mset_plain.size());
+    TEST(mset_range_is_same(mset, 0, mset_plain, 0, mset.size()));
+    TEST_EQUAL(db.get_document(*mset[0]).get_data(),
+	       db_plain.get_document(*mset_plain[0]).get_data());
+
+    // Check that we still see changes after reopen(), which will need to
+    // map the grown tables.
+    Xapian::Document doc;
+    doc.add_term("paragraph");
+    doc.set_data("new");
+    for (int i = 0; i < 1000; ++i) {
+	doc.add_term("t" + str(i));
+	wdb.add_document(doc);
+    }
+    wdb.commit();
+    {
+	EnvVarSetter mmap_readonly("XAPIAN_MMAP_READONLY", "1");
+	db.reopen();
+    }
+    TEST_EQUAL(db.get_doccount(), db_plain.get_doccount() + 1000);
+    TEST_EQUAL(db.get_termfreq("paragraph"),
+	       db_plain.get_termfreq("paragraph") + 1000);
+    TEST_EQUAL(db.get_document(db.get_lastdocid()).get_data(), "new");
+    TEST_EQUAL(db.get_doclength(db.get_lastdocid()), 1001);
+    return true;
+#endif
+}
+
 /// Coverage for SelectPostList::skip_to().
 DEFINE_TESTCASE(phrase3, positional) {
     Xapian::Database db = get_database("apitest_phrase");
@@ -844,3 +965,251 @@ DEFINE_TESTCASE(msetweights1, backend) {
 
     return true;
 }
+
+/// Check large messages round-trip (the remote backend compresses them).
+DEFINE_TESTCASE(bigmessages1, writable) {
+    Xapian::WritableDatabase db = get_writable_database();
+    // Document data which compresses well, and a sort key which doesn't.
+    string data;
+    for (int i = 0; i < 10000; ++i) {
+	data += "lots and lots of repeated data ";
+	data += str(i % 7);
+    }
+    for (Xapian::docid did = 1; did <= 20; ++did) {
+	string key;
+	unsigned x = did;
+	for (int i = 0; i < 8000; ++i) {
+	    x = x * 1103515245 + 12345;
+	    key += char(x >> 16);
+	}
+	Xapian::Document doc;
+	doc.set_data(data + str(did));
+	doc.add_value(0, key);
+	doc.add_term("big");
+	db.add_document(doc);
+    }
+    db.commit();
+
+    Xapian::Enquire enq(db);
+    enq.set_query(Xapian::Query("big"));
+    enq.set_sort_by_value(0, false);
+    enq.set_collapse_key(0);
+    Xapian::MSet mset = enq.get_mset(0, 20);
+    TEST_EQUAL(mset.size(), 20);
+    for (Xapian::MSetIterator i = mset.begin(); i != mset.end(); ++i) {
+	Xapian::Document doc = i.get_document();
+	TEST_EQUAL(doc.get_data(), data + str(*i));
+	TEST_EQUAL(doc.get_value(0).size(), 8000);
+	if (i != mset.begin()) {
+	    Xapian::MSetIterator prev = i;
+	    --prev;
+	    TEST_REL(prev.get_document().get_value(0),<=,doc.get_value(0));
+	}
+    }
+
+    return true;
+}
+
+/// Check adding in key order to a table with free blocks in it.
+DEFINE_TESTCASE(seqholes1, brass) {
+    Xapian::WritableDatabase db = get_named_writable_database("seqholes1");
+    // Data which doesn't compress, so the record table gets a leaf block for
+    // every few documents.
+    unsigned x = 1;
+    vector<string> datas;
+    for (Xapian::docid did = 1; did <= 3000; ++did) {
+	string data;
+	for (int i = 0; i < 600; ++i) {
+	    x = x * 1103515245 + 12345;
+	    data += char(x >> 16);
+	}
+	datas.push_back(data);
+    }
+
+    for (Xapian::docid did = 1; did <= 1500; ++did) {
+	Xapian::Document doc;
+	doc.set_data(datas[did - 1]);
+	db.add_document(doc);
+    }
+    db.commit();
+    // Free up blocks all through the table.
+    for (Xapian::docid did = 1; did <= 1500; ++did) {
+	if (did % 4 != 0) db.delete_document(did);
+    }
+    db.commit();
+    // Then add documents, which will be in key order in the record table,
+    // so new leaf blocks are allocated to follow the one they're split from
+    // where they can be, and from the free blocks where they can't.
+    for (Xapian::docid did = 1501; did <= 3000; ++did) {
+	Xapian::Document doc;
+	doc.set_data(datas[did - 1]);
+	db.add_document(doc);
+    }
+    db.commit();
+
+    for (Xapian::docid did = 1; did <= 3000; ++did) {
+	if (did <= 1500 && did % 4 != 0) continue;
+	TEST_EQUAL(db.get_document(did).get_data(), datas[did - 1]);
+    }
+    db.close();
+
+    string path = get_named_writable_database_path("seqholes1");
+    TEST_EQUAL(Xapian::Database::check(path, 0, tout), 0);
+
+    return true;
+}
+
+/// Check term stats are read when a postlist's first item is short.
+DEFINE_TESTCASE(termstatsshortitem1, brass) {
+    string path = get_named_writable_database_path("termstatsshortitem1");
+    // With a small block size, postlist tags span several items, and when
+    // a new tag is added the first item may only get the few bytes which
+    // are free in the leaf block.
+    Xapian::WritableDatabase db =
+	Xapian::Brass::open(path, Xapian::DB_CREATE_OR_OVERWRITE, 2048);
+    // This seed gives a postlist whose first item holds just 2 bytes.
+    unsigned x = 27;
+    for (int d = 0; d != 3000; ++d) {
+	Xapian::Document doc;
+	for (int t = 0; t != 30; ++t) {
+	    x = x * 1103515245 + 12345;
+	    doc.add_term("t" + str((x >> 16) % 400));
+	}
+	db.add_document(doc);
+    }
+    db.commit();
+
+    Xapian::Database rodb(path);
+    for (int t = 0; t != 400; ++t) {
+	string term = "t" + str(t);
+	Xapian::doccount termfreq = 0;
+	Xapian::termcount collfreq = 0;
+	Xapian::PostingIterator p;
+	for (p = rodb.postlist_begin(term); p != rodb.postlist_end(term); ++p) {
+	    ++termfreq;
+	    collfreq += p.get_wdf();
+	}
+	TEST_EQUAL(rodb.get_termfreq(term), termfreq);
+	TEST_EQUAL(rodb.get_collection_freq(term), collfreq);
+	TEST_REL(rodb.get_wdf_upper_bound(term), >=, 1);
+    }
+
+    return true;
+}
+
+/// Check tags which compress poorly or well round-trip.
+DEFINE_TESTCASE(tagcompress1, writable) {
+    Xapian::WritableDatabase db = get_writable_database();
+    // Each piece of data is pseudo-random bytes with a run of a repeated
+    // byte making up a given fraction of it, so some will be stored
+    // compressed and some won't.
+    vector<string> datas;
+    unsigned x = 1;
+    static const size_t sizes[] = { 5, 6, 9, 17, 100, 1000, 20000 };
+    for (size_t s = 0; s != sizeof(sizes) / sizeof(sizes[0]); ++s) {
+	size_t size = sizes[s];
+	for (size_t run_pct = 0; run_pct <= 100; run_pct += 5) {
+	    size_t run = size * run_pct / 100;
+	    string data(run, 'x');
+	    while (data.size() < size) {
+		x = x * 1103515245 + 12345;
+		data += char(x >> 16);
+	    }
+	    Xapian::Document doc;
+	    doc.set_data(data);
+	    db.add_document(doc);
+	    datas.push_back(data);
+	}
+    }
+    db.commit();
+
+    for (Xapian::docid did = 1; did <= datas.size(); ++did) {
+	TEST_EQUAL(db.get_document(did).get_data(), datas[did - 1]);
+    }
+
+    return true;
+}
+
+/// Terms starting with '~' count towards the document length by default.
+DEFINE_TESTCASE(edgengramdoclen1, writable) {
+    Xapian::WritableDatabase db = get_writable_database();
+    Xapian::Document doc;
+    doc.add_term("mule", 2);
+    doc.add_term("~m", 2);
+    doc.add_term("~mu", 2);
+    db.add_document(doc);
+    db.commit();
+
+    TEST_EQUAL(db.get_doclength(1), 6);
+    TEST_EQUAL(db.get_avlength(), 6);
+
+    return true;
+}
+
+/// Databases created with DB_EDGE_NGRAMS don't count '~' terms in doclen.
+DEFINE_TESTCASE(edgengramdoclen2, brass) {
+    string path = get_named_writable_database_path("edgengramdoclen2");
+    Xapian::WritableDatabase db =
+	Xapian::Brass::open(path,
+			    Xapian::DB_CREATE_OR_OVERWRITE |
+			    Xapian::DB_EDGE_NGRAMS);
+    Xapian::Document doc;
+    doc.add_term("mule", 2);
+    doc.add_term("~m", 2);
+    doc.add_term("~mu", 2);
+    db.add_document(doc);
+    db.add_document(doc);
+    db.commit();
+    TEST_EQUAL(db.get_doclength(1), 2);
+    TEST_EQUAL(db.get_avlength(), 2);
+
+    // Replacing and deleting must adjust the total length by the same
+    // amount it was adjusted by when the document was added.
+    Xapian::Document doc2;
+    doc2.add_term("mutton", 3);
+    doc2.add_term("~mut", 3);
+    db.replace_document(1, doc2);
+    db.delete_document(2);
+    db.commit();
+    TEST_EQUAL(db.get_doclength(1), 3);
+    TEST_EQUAL(db.get_avlength(), 3);
+    db.close();
+
+    // The flag is recorded in the database, so it still applies when the
+    // database is reopened without it.
+    db = Xapian::Brass::open(path, Xapian::DB_OPEN);
+    db.add_document(doc);
+    db.commit();
+    TEST_EQUAL(db.get_doclength(3), 2);
+    db.close();
+
+    TEST_EQUAL(Xapian::Database::check(path, 0, tout), 0);
+
+    // Compacting keeps the flag.
+    string out = path + "_compacted";
+    {
+	Xapian::Compactor compact;
+	compact.set_destdir(out);
+	compact.add_source(path);
+	compact.compact();
+    }
+    db = Xapian::Brass::open(out, Xapian::DB_OPEN);
+    db.replace_document(3, doc2);
+    db.commit();
+    TEST_EQUAL(db.get_doclength(3), 3);
+    db.close();
+    TEST_EQUAL(Xapian::Database::check(out, 0, tout), 0);
+
+    // Databases created with different options can't be merged.
+    string plain = get_named_writable_database_path("edgengramdoclen2_plain");
+    Xapian::Brass::open(plain, Xapian::DB_CREATE_OR_OVERWRITE).add_document(doc);
+    {
+	Xapian::Compactor compact;
+	compact.set_destdir(path + "_merged");
+	compact.add_source(path);
+	compact.add_source(plain);
+	TEST_EXCEPTION(Xapian::InvalidArgumentError, compact.compact());
+    }
+
+    return true;
+}
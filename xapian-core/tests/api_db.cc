@@ -26,6 +26,7 @@
 #include "api_db.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <map>
 #include <string>
@@ -37,6 +38,7 @@
 
 #include "backendmanager.h"
 #include "backendmanager_local.h"
+#include "str.h"
 #include "testsuite.h"
 #include "testutils.h"
 #include "unixcmds.h"
@@ -1752,6 +1754,161 @@ DEFINE_TESTCASE(netstats1, remote) {
     return true;
 }
 
+// Test repeating a query (which reuses the remote stats) gives the same results.
+DEFINE_TESTCASE(netstats2, remote) {
+    BackendManagerLocal local_manager;
+    local_manager.set_datadir(test_driver::get_srcdir() + "/testdata/");
+
+    const char * words[] = { "paragraph", "word" };
+    Xapian::Query query(Xapian::Query::OP_OR, words, words + 2);
+    const size_t MSET_SIZE = 10;
+
+    Xapian::RSet rset;
+    rset.add_document(4);
+    rset.add_document(9);
+
+    Xapian::MSet mset_alllocal, mset_alllocal_rset;
+    {
+	Xapian::Database db;
+	db.add_database(local_manager.get_database("apitest_simpledata"));
+	db.add_database(local_manager.get_database("apitest_simpledata2"));
+
+	Xapian::Enquire enq(db);
+	enq.set_query(query);
+	mset_alllocal = enq.get_mset(0, MSET_SIZE);
+	mset_alllocal_rset = enq.get_mset(0, MSET_SIZE, &rset);
+    }
+
+    Xapian::Database db;
+    db.add_database(local_manager.get_database("apitest_simpledata"));
+    db.add_database(get_database("apitest_simpledata2"));
+
+    Xapian::Enquire enq(db);
+    enq.set_query(query);
+    for (int i = 0; i < 3; ++i) {
+	Xapian::MSet mset = enq.get_mset(0, MSET_SIZE);
+	TEST_EQUAL(mset.size(), mset_alllocal.size());
+	TEST_EQUAL(mset.get_max_attained(), mset_alllocal.get_max_attained());
+	TEST(mset_range_is_same(mset, 0, mset_alllocal, 0, mset.size()));
+
+	// The stats depend on the rset, so check changing it works too.
+	mset = enq.get_mset(0, MSET_SIZE, &rset);
+	TEST_EQUAL(mset.size(), mset_alllocal_rset.size());
+	TEST_EQUAL(mset.get_max_attained(), mset_alllocal_rset.get_max_attained());
+	TEST(mset_range_is_same(mset, 0, mset_alllocal_rset, 0, mset.size()));
+    }
+
+    return true;
+}
+
+// Test the remote stats for a query are updated by reopen().
+DEFINE_TESTCASE(netstats3, remote && writable) {
+    Xapian::WritableDatabase wdb = get_writable_database();
+    Xapian::Document doc;
+    doc.add_term("foo");
+    wdb.add_document(doc);
+    wdb.add_document(Xapian::Document());
+    wdb.commit();
+
+    Xapian::Database db = get_writable_database_as_database();
+    Xapian::Enquire enq(db);
+    enq.set_query(Xapian::Query("foo"));
+    Xapian::MSet mset1 = enq.get_mset(0, 10);
+    Xapian::MSet mset2 = enq.get_mset(0, 10);
+    TEST_EQUAL(mset1.get_termfreq("foo"), 1);
+    TEST_EQUAL(mset2.get_termfreq("foo"), 1);
+    TEST(mset_range_is_same_weights(mset1, 0, mset2, 0, 1));
+
+    wdb.add_document(doc);
+    wdb.commit();
+    // The read-only database still sees the old revision.
+    mset2 = enq.get_mset(0, 10);
+    TEST_EQUAL(mset2.get_termfreq("foo"), 1);
+    TEST_EQUAL(mset2.size(), 1);
+
+    TEST(db.reopen());
+    mset2 = enq.get_mset(0, 10);
+    TEST_EQUAL(mset2.get_termfreq("foo"), 2);
+    TEST_EQUAL(mset2.size(), 2);
+    TEST_NOT_EQUAL_DOUBLE(mset1[0].get_weight(), mset2[0].get_weight());
+
+    return true;
+}
+
+static void
+make_netbatch_db(Xapian::WritableDatabase &db, const string & arg)
+{
+    // Shard "0" gets most of the best matches.
+    int shard = atoi(arg.c_str());
+    for (int i = 0; i != 150; ++i) {
+	Xapian::Document doc;
+	int wdf = (i * 7 + shard * 13) % 20 + 1;
+	if (shard == 0) wdf += 20;
+	doc.add_term("foo", wdf);
+	doc.add_term("bar", 41 - wdf);
+	db.add_document(doc);
+    }
+}
+
+// Test fetching results from remote databases in batches.
+DEFINE_TESTCASE(netbatch1, remote && writable) {
+    const int N_SHARDS = 4;
+    Xapian::Database db, db_local;
+    for (int i = 0; i != N_SHARDS; ++i) {
+	string arg = str(i);
+	Xapian::WritableDatabase remote =
+	    get_named_writable_database("netbatch1_" + arg);
+	make_netbatch_db(remote, arg);
+	remote.commit();
+	db.add_database(remote);
+	Xapian::WritableDatabase local = Xapian::InMemory::open();
+	make_netbatch_db(local, arg);
+	db_local.add_database(local);
+    }
+
+    Xapian::Enquire enq(db), enq_local(db_local);
+    Xapian::Query query("foo");
+    enq.set_query(query);
+    enq_local.set_query(query);
+
+    static const Xapian::doccount windows[][2] = {
+	{ 0, 10 }, { 100, 10 }, { 140, 20 }, { 0, 200 }, { 550, 100 }
+    };
+    for (size_t i = 0; i != sizeof(windows) / sizeof(windows[0]); ++i) {
+	Xapian::doccount first = windows[i][0];
+	Xapian::doccount maxitems = windows[i][1];
+	tout << "first = " << first << ", maxitems = " << maxitems << endl;
+	Xapian::MSet mset = enq.get_mset(first, maxitems);
+	Xapian::MSet mset_local = enq_local.get_mset(first, maxitems);
+	TEST_EQUAL(mset.size(), mset_local.size());
+	TEST(mset_range_is_same(mset, 0, mset_local, 0, mset.size()));
+	TEST_EQUAL(mset.get_matches_lower_bound(), mset_local.get_matches_lower_bound());
+	TEST_EQUAL(mset.get_matches_upper_bound(), mset_local.get_matches_upper_bound());
+    }
+
+    // A weight cutoff should be honoured when fetching more results too.
+    Xapian::MSet mset_local = enq_local.get_mset(0, 200);
+    double cutoff = mset_local[180].get_weight();
+    enq.set_cutoff(0, cutoff);
+    enq_local.set_cutoff(0, cutoff);
+    Xapian::MSet mset = enq.get_mset(100, 150);
+    mset_local = enq_local.get_mset(100, 150);
+    TEST_REL(mset.size(),>,0);
+    TEST_REL(mset.size(),<,150);
+    TEST_EQUAL(mset.size(), mset_local.size());
+    TEST(mset_range_is_same(mset, 0, mset_local, 0, mset.size()));
+
+    // Check that the query which follows fetching more results works.
+    enq.set_query(Xapian::Query("bar"));
+    enq_local.set_query(Xapian::Query("bar"));
+    mset = enq.get_mset(0, 100);
+    mset_local = enq_local.get_mset(0, 100);
+    TEST_EQUAL(mset.size(), mset_local.size());
+    TEST(mset_range_is_same(mset, 0, mset_local, 0, mset.size()));
+
+    return true;
+}
+
 // Coordinate matching - scores 1 for each matching term
 class MyWeight : public Xapian::Weight {
     double scale_factor;
@@ -146,3 +146,77 @@ DEFINE_TESTCASE(qpsynonympartial1, synonyms) {
 
     return true;
 }
+
+// Test edge n-grams are weighted like the wildcard expansion they replace.
+DEFINE_TESTCASE(qpedgengram1, brass) {
+    // Only databases created with DB_EDGE_NGRAMS leave the n-grams out of
+    // the document lengths.
+    Xapian::WritableDatabase db =
+	Xapian::Brass::open(get_named_writable_database_path("qpedgengram1"),
+			    Xapian::DB_CREATE_OR_OVERWRITE |
+			    Xapian::DB_EDGE_NGRAMS);
+    Xapian::WritableDatabase db_plain =
+	get_named_writable_database("qpedgengram1_plain");
+    Xapian::TermGenerator termgen;
+    const char * texts[] = {
+	"muscat main main main",
+	"mutton mutton mule mule",
+	"main street",
+	"mussel",
+	"abc def ghi jkl mno pqr stu vwx mule"
+    };
+    for (size_t i = 0; i != sizeof(texts) / sizeof(texts[0]); ++i) {
+	Xapian::Document doc;
+	termgen.set_document(doc);
+	termgen.set_max_edge_ngram_length(3);
+	termgen.index_text(texts[i]);
+	db.add_document(doc);
+
+	Xapian::Document doc_plain;
+	termgen.set_document(doc_plain);
+	termgen.set_max_edge_ngram_length(0);
+	termgen.index_text(texts[i]);
+	db_plain.add_document(doc_plain);
+    }
+    db.commit();
+    db_plain.commit();
+
+    // The n-grams mustn't change the document lengths.
+    for (Xapian::docid did = 1; did <= db.get_doccount(); ++did) {
+	TEST_EQUAL(db.get_doclength(did), db_plain.get_doclength(did));
+    }
+    TEST_EQUAL(db.get_avlength(), db_plain.get_avlength());
+
+    Xapian::QueryParser qp;
+    qp.set_database(db);
+    qp.set_max_edge_ngram_length(3);
+    Xapian::QueryParser qp_wild;
+    qp_wild.set_database(db_plain);
+    unsigned flags = Xapian::QueryParser::FLAG_PARTIAL;
+
+    // BM25 is the default weighting scheme.
+    Xapian::Enquire enquire(db);
+    Xapian::Enquire enquire_wild(db_plain);
+    const char * queries[] = { "m", "mu", "mus", "main mu" };
+    for (size_t i = 0; i != sizeof(queries) / sizeof(queries[0]); ++i) {
+	tout << "Query: " << queries[i] << '\n';
+	enquire.set_query(qp.parse_query(queries[i], flags));
+	Xapian::MSet mset = enquire.get_mset(0, 10);
+	enquire_wild.set_query(qp_wild.parse_query(queries[i], flags));
+	Xapian::MSet mset_wild = enquire_wild.get_mset(0, 10);
+	TEST_EQUAL(mset.size(), mset_wild.size());
+	for (Xapian::doccount j = 0; j != mset.size(); ++j) {
+	    TEST_EQUAL(*mset[j], *mset_wild[j]);
+	    TEST_REL(mset[j].get_weight(), >, 0);
+	}
+    }
+
+    // The document mentioning "mu..." most often should rank first.
+    enquire.set_query(qp.parse_query("mu", flags));
+    Xapian::MSet mset = enquire.get_mset(0, 10);
+    TEST_EQUAL(mset.size(), 4);
+    TEST_EQUAL(*mset[0], 2);
+    TEST_REL(mset[0].get_weight(), >, mset[1].get_weight());
+
+    return true;
+}
@@ -25,10 +25,17 @@
 
 #include <xapian.h>
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "testsuite.h"
 #include "testutils.h"
 
 #include "apitest.h"
+#include "filetests.h"
+#include "stringutils.h"
 
 using namespace std;
 
@@ -178,3 +185,408 @@ DEFINE_TESTCASE(xor3, backend) {
 
     return true;
 }
+
+/// Test that an N-way OR gives the same top results when it decays.
+DEFINE_TESTCASE(multior1, backend) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    const char * subqs[] = {
+	"this", "paragraph", "word", "hack", "which", "return"
+    };
+    Xapian::Query q(Xapian::Query::OP_OR, subqs, subqs + 6);
+    Xapian::Enquire enq(db);
+    enq.set_query(q);
+    Xapian::MSet full = enq.get_mset(0, db.get_doccount());
+    TEST_EQUAL(full.size(), db.get_doccount());
+
+    // Asking for fewer results lets the matcher raise the minimum weight,
+    // which makes the OR decay to AND_MAYBE part way through the match.
+    for (Xapian::doccount n = 1; n < full.size(); ++n) {
+	tout << "Checking top " << n << " results" << endl;
+	Xapian::MSet mset = enq.get_mset(0, n);
+	TEST(mset_range_is_same(mset, 0, full, 0, n));
+	TEST(mset_range_is_same_weights(mset, 0, full, 0, n));
+    }
+
+    return true;
+}
+
+/// Check queries which repeat terms give the same results for a read-only
+/// database (which can open postlists from previously opened ones) as for a
+/// writable one.
+DEFINE_TESTCASE(repeatedterms1, writable) {
+    Xapian::Database db = get_database("apitest_simpledata");
+    Xapian::Database wdb = get_writable_database("apitest_simpledata");
+
+    const char * terms[] = {
+	"this", "paragraph", "this", "word", "paragraph", "this"
+    };
+    Xapian::Query elite(Xapian::Query::OP_ELITE_SET,
+			terms + 1, terms + 4, 1);
+    Xapian::Query q(Xapian::Query::OP_OR, terms, terms + 6);
+    q = Xapian::Query(Xapian::Query::OP_OR, q, elite);
+    q = Xapian::Query(Xapian::Query::OP_AND_MAYBE, q, Xapian::Query("word"));
+
+    Xapian::Enquire enquire(db);
+    enquire.set_query(q);
+    Xapian::MSet mset = enquire.get_mset(0, 10);
+    Xapian::Enquire wenquire(wdb);
+    wenquire.set_query(q);
+    Xapian::MSet wmset = wenquire.get_mset(0, 10);
+
+    TEST(!mset.empty());
+    TEST_EQUAL(mset.size(), wmset.size());
+    for (Xapian::doccount i = 0; i != mset.size(); ++i) {
+	TEST_EQUAL(*mset[i], *wmset[i]);
+	TEST_EQUAL_DOUBLE(mset[i].get_weight(), wmset[i].get_weight());
+    }
+
+    return true;
+}
+
+/// Check OP_WILDCARD matches and weights like the equivalent OP_SYNONYM.
+DEFINE_TESTCASE(wildcard1, backend) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    vector<Xapian::Query> subqs;
+    Xapian::TermIterator t;
+    for (t = db.allterms_begin("th"); t != db.allterms_end("th"); ++t)
+	subqs.push_back(Xapian::Query(*t));
+    TEST_REL(subqs.size(),>=,3);
+
+    Xapian::Query syn(Xapian::Query::OP_SYNONYM, subqs.begin(), subqs.end());
+    Xapian::Query wild(Xapian::Query::OP_WILDCARD, "th");
+    TEST_STRINGS_EQUAL(wild.get_description(), "Query(WILDCARD th)");
+    Xapian::Query wild2 = Xapian::Query::unserialise(wild.serialise());
+    TEST_STRINGS_EQUAL(wild2.get_description(), wild.get_description());
+
+    Xapian::Enquire enq(db);
+    for (int i = 0; i != 2; ++i) {
+	enq.set_query(syn);
+	Xapian::MSet mset1 = enq.get_mset(0, db.get_doccount());
+	enq.set_query(wild);
+	Xapian::MSet mset2 = enq.get_mset(0, db.get_doccount());
+	TEST(!mset1.empty());
+	TEST_EQUAL(mset1.size(), mset2.size());
+	TEST(mset_range_is_same(mset1, 0, mset2, 0, mset1.size()));
+	TEST(mset_range_is_same_weights(mset1, 0, mset2, 0, mset1.size()));
+
+	// Check again with the wildcard as a weighted subquery.
+	syn = Xapian::Query(Xapian::Query::OP_OR, syn, Xapian::Query("word"));
+	wild = Xapian::Query(Xapian::Query::OP_OR, wild, Xapian::Query("word"));
+    }
+
+    // A wildcard which matches nothing.
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "zzzz"));
+    TEST(enq.get_mset(0, 10).empty());
+
+    return true;
+}
+
+/// Check the OP_WILDCARD expansion limits.
+DEFINE_TESTCASE(wildcard2, backend && !multi) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    vector<string> terms;
+    string most_frequent;
+    Xapian::doccount max_tf = 0;
+    Xapian::TermIterator t;
+    for (t = db.allterms_begin("th"); t != db.allterms_end("th"); ++t) {
+	terms.push_back(*t);
+	if (t.get_termfreq() > max_tf) {
+	    max_tf = t.get_termfreq();
+	    most_frequent = *t;
+	}
+    }
+    Xapian::termcount n = terms.size();
+    TEST_REL(n,>=,3);
+
+    Xapian::Enquire enq(db);
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "th", n));
+    Xapian::MSet mset = enq.get_mset(0, 10);
+    TEST(!mset.empty());
+
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "th", n - 1));
+    TEST_EXCEPTION(Xapian::WildcardError, enq.get_mset(0, 10));
+
+    // Compare the matching documents in docid order for the other limits.
+    enq.set_weighting_scheme(Xapian::BoolWeight());
+
+    // WILDCARD_LIMIT_FIRST should use the first term in sort order.
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "th", 1,
+				Xapian::Query::WILDCARD_LIMIT_FIRST));
+    mset = enq.get_mset(0, db.get_doccount());
+    enq.set_query(Xapian::Query(Xapian::Query::OP_SYNONYM,
+				terms.begin(), terms.begin() + 1));
+    Xapian::MSet mset2 = enq.get_mset(0, db.get_doccount());
+    TEST_EQUAL(mset.size(), mset2.size());
+    TEST(mset_range_is_same(mset, 0, mset2, 0, mset.size()));
+
+    // WILDCARD_LIMIT_MOST_FREQUENT should use the term with the highest
+    // termfreq.
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "th", 1,
+				Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT));
+    mset = enq.get_mset(0, db.get_doccount());
+    TEST_EQUAL(mset.size(), max_tf);
+    enq.set_query(Xapian::Query(Xapian::Query::OP_SYNONYM,
+				&most_frequent, &most_frequent + 1));
+    mset2 = enq.get_mset(0, db.get_doccount());
+    TEST(mset_range_is_same(mset, 0, mset2, 0, mset.size()));
+
+    return true;
+}
+
+/// Order (termfreq, term) pairs by descending termfreq, then by term.
+static bool
+more_frequent(const pair<Xapian::doccount, string> & a,
+	      const pair<Xapian::doccount, string> & b)
+{
+    if (a.first != b.first) return a.first > b.first;
+    return a.second < b.second;
+}
+
+/// Check a limited OP_WILDCARD weights like an OP_SYNONYM of the terms used.
+DEFINE_TESTCASE(wildcardlimit1, backend && !multi) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    vector<pair<Xapian::doccount, string> > freqs;
+    Xapian::TermIterator t;
+    for (t = db.allterms_begin("th"); t != db.allterms_end("th"); ++t)
+	freqs.push_back(make_pair(t.get_termfreq(), *t));
+    TEST_REL(freqs.size(),>=,3);
+
+    Xapian::Enquire enq(db);
+    // A single term would be weighted differently from a synonym.
+    for (Xapian::termcount limit = 2; limit != freqs.size(); ++limit) {
+	tout << "limit " << limit << endl;
+	for (int type = Xapian::Query::WILDCARD_LIMIT_FIRST;
+	     type <= Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT; ++type) {
+	    vector<pair<Xapian::doccount, string> > chosen(freqs);
+	    if (type == Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT)
+		sort(chosen.begin(), chosen.end(), more_frequent);
+	    chosen.resize(limit);
+	    vector<string> terms;
+	    for (size_t i = 0; i != chosen.size(); ++i)
+		terms.push_back(chosen[i].second);
+	    sort(terms.begin(), terms.end());
+
+	    Xapian::Query wild(Xapian::Query::OP_WILDCARD, "th", limit, type);
+	    enq.set_query(Xapian::Query(Xapian::Query::OP_OR,
+					wild, Xapian::Query("word")));
+	    Xapian::MSet mset = enq.get_mset(0, db.get_doccount());
+	    vector<string> used(wild.get_terms_begin(), wild.get_terms_end());
+	    TEST(used == terms);
+
+	    Xapian::Query syn(Xapian::Query::OP_SYNONYM,
+			      terms.begin(), terms.end());
+	    enq.set_query(Xapian::Query(Xapian::Query::OP_OR,
+					syn, Xapian::Query("word")));
+	    Xapian::MSet mset2 = enq.get_mset(0, db.get_doccount());
+	    TEST_EQUAL(mset.size(), mset2.size());
+	    TEST(mset_range_is_same(mset, 0, mset2, 0, mset.size()));
+	    TEST(mset_range_is_same_weights(mset, 0, mset2, 0, mset.size()));
+	}
+    }
+
+    return true;
+}
+
+struct wildcard_testcase {
+    const char * pattern;
+    const char * prefix;
+    const char * infix;
+    const char * suffix;
+};
+
+/// Check OP_WILDCARD patterns which contain '*'.
+DEFINE_TESTCASE(wildcard3, backend) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    static const wildcard_testcase testcases[] = {
+	{ "*s",		"",	"",	"s" },
+	{ "*is*",	"",	"is",	"" },
+	{ "t*e",	"t",	"",	"e" },
+	{ "*h*s",	"",	"h",	"s" },
+	{ "th*",	"th",	"",	"" }
+    };
+    for (size_t i = 0; i != sizeof(testcases) / sizeof(testcases[0]); ++i) {
+	const wildcard_testcase & tc = testcases[i];
+	tout << tc.pattern << endl;
+	string prefix(tc.prefix), infix(tc.infix), suffix(tc.suffix);
+	vector<Xapian::Query> subqs;
+	Xapian::TermIterator t;
+	for (t = db.allterms_begin(prefix); t != db.allterms_end(prefix); ++t) {
+	    const string & term = *t;
+	    if (term.size() < prefix.size() + infix.size() + suffix.size())
+		continue;
+	    if (term.compare(term.size() - suffix.size(), string::npos,
+			     suffix) != 0)
+		continue;
+	    string middle(term, prefix.size(),
+			  term.size() - prefix.size() - suffix.size());
+	    if (middle.find(infix) == string::npos)
+		continue;
+	    subqs.push_back(Xapian::Query(term));
+	}
+	// A single term would be weighted differently from a synonym.
+	TEST_REL(subqs.size(),>=,2);
+
+	Xapian::Query syn(Xapian::Query::OP_SYNONYM, subqs.begin(), subqs.end());
+	Xapian::Query wild(Xapian::Query::OP_WILDCARD, tc.pattern);
+	Xapian::Query wild2 = Xapian::Query::unserialise(wild.serialise());
+	TEST_STRINGS_EQUAL(wild2.get_description(), wild.get_description());
+
+	Xapian::Enquire enq(db);
+	enq.set_query(syn);
+	Xapian::MSet mset1 = enq.get_mset(0, db.get_doccount());
+	enq.set_query(wild);
+	Xapian::MSet mset2 = enq.get_mset(0, db.get_doccount());
+	TEST_EQUAL(mset1.size(), mset2.size());
+	TEST(mset_range_is_same(mset1, 0, mset2, 0, mset1.size()));
+	TEST(mset_range_is_same_weights(mset1, 0, mset2, 0, mset1.size()));
+    }
+
+    Xapian::Enquire enq(db);
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "*zzzz*"));
+    TEST(enq.get_mset(0, 10).empty());
+
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, "*s", 1));
+    TEST_EXCEPTION(Xapian::WildcardError, enq.get_mset(0, 10));
+
+    return true;
+}
+
+/// Check the terms an OP_WILDCARD expands to count as query terms.
+DEFINE_TESTCASE(wildcardterms1, backend) {
+    Xapian::Database db = get_database("apitest_simpledata");
+
+    vector<string> terms;
+    Xapian::TermIterator t;
+    for (t = db.allterms_begin("th"); t != db.allterms_end("th"); ++t)
+	terms.push_back(*t);
+    TEST_REL(terms.size(),>=,3);
+
+    Xapian::Query wild(Xapian::Query::OP_WILDCARD, "th");
+    Xapian::Query query(Xapian::Query::OP_OR, wild, Xapian::Query("word"));
+    // Not expanded until the match runs.
+    TEST(query.get_terms_begin() != query.get_terms_end());
+    TEST_EQUAL(*query.get_terms_begin(), "word");
+    TEST(wild.get_terms_begin() == wild.get_terms_end());
+
+    Xapian::Enquire enq(db);
+    enq.set_query(query);
+    Xapian::MSet mset = enq.get_mset(0, 10);
+    TEST(!mset.empty());
+
+    vector<string> wild_terms(wild.get_terms_begin(), wild.get_terms_end());
+    TEST(wild_terms == terms);
+    Xapian::termcount n = 0;
+    for (t = query.get_terms_begin(); t != query.get_terms_end(); ++t) {
+	TEST(*t == "word" || startswith(*t, "th"));
+	++n;
+    }
+    TEST_EQUAL(n, terms.size() + 1);
+
+    // Every document matched via the wildcard should report the terms it
+    // matched.
+    Xapian::MSetIterator m;
+    for (m = mset.begin(); m != mset.end(); ++m) {
+	t = enq.get_matching_terms_begin(m);
+	TEST(t != enq.get_matching_terms_end(m));
+	for ( ; t != enq.get_matching_terms_end(m); ++t) {
+	    TEST(*t == "word" || startswith(*t, "th"));
+	}
+    }
+
+    // The expanded terms shouldn't be suggested by query expansion.
+    Xapian::RSet rset;
+    for (m = mset.begin(); m != mset.end(); ++m)
+	rset.add_document(*m);
+    Xapian::ESet eset = enq.get_eset(100, rset);
+    TEST(!eset.empty());
+    Xapian::ESetIterator e;
+    for (e = eset.begin(); e != eset.end(); ++e) {
+	TEST(!startswith(*e, "th"));
+	TEST_NOT_EQUAL(*e, "word");
+    }
+
+    return true;
+}
+
+static Xapian::doccount
+count_matches(const Xapian::Database & db, const char * pattern)
+{
+    Xapian::Enquire enq(db);
+    enq.set_query(Xapian::Query(Xapian::Query::OP_WILDCARD, pattern));
+    return enq.get_mset(0, db.get_doccount()).size();
+}
+
+/// Check the brass permuterm index is built and kept up to date.
+DEFINE_TESTCASE(permuterm1, brass) {
+    string path = get_named_writable_database_path("permuterm1");
+    static const char * const words[] = {
+	"testing", "resting", "tested", "version", "universe", "diverse", NULL
+    };
+    {
+	// Build a database without the index, then enable it.
+	Xapian::WritableDatabase db =
+	    Xapian::Brass::open(path, Xapian::DB_CREATE_OR_OVERWRITE);
+	for (const char * const * w = words; *w; ++w) {
+	    Xapian::Document doc;
+	    doc.add_term(*w);
+	    db.add_document(doc);
+	}
+	db.commit();
+    }
+    TEST(!file_exists(path + "/permuterm.DB"));
+
+    Xapian::WritableDatabase db =
+	Xapian::Brass::open(path, Xapian::DB_OPEN | Xapian::DB_PERMUTERM);
+    TEST(file_exists(path + "/permuterm.DB"));
+    TEST_EQUAL(count_matches(db, "*ing"), 2);
+    TEST_EQUAL(count_matches(db, "*vers*"), 3);
+    TEST_EQUAL(count_matches(db, "t*d"), 1);
+    TEST_EQUAL(count_matches(db, "*e"), 2);
+    TEST_EQUAL(count_matches(db, "*es*ng"), 2);
+    TEST_EQUAL(count_matches(db, "*ers*e"), 2);
+    TEST_EQUAL(count_matches(db, "version"), 1);
+    TEST_EQUAL(count_matches(db, "*zzz*"), 0);
+
+    // Check uncommitted changes are seen.
+    Xapian::Document doc;
+    doc.add_term("sing");
+    doc.add_term("verse");
+    Xapian::docid did = db.add_document(doc);
+    TEST_EQUAL(count_matches(db, "*ing"), 3);
+    TEST_EQUAL(count_matches(db, "*vers*"), 4);
+    db.delete_document(did);
+    db.delete_document(5);
+    TEST_EQUAL(count_matches(db, "*ing"), 2);
+    TEST_EQUAL(count_matches(db, "*vers*"), 2);
+    db.commit();
+
+    // The index is kept up to date without DB_PERMUTERM once it exists.
+    db.close();
+    db = Xapian::Brass::open(path, Xapian::DB_OPEN);
+    db.add_document(doc);
+    db.commit();
+
+    Xapian::Database rodb = Xapian::Brass::open(path);
+    TEST_EQUAL(count_matches(rodb, "*ing"), 3);
+    TEST_EQUAL(count_matches(rodb, "*vers*"), 3);
+    TEST_EQUAL(count_matches(rodb, "*ers*e"), 2);
+
+    // Check a new database with the index.
+    db.close();
+    db = Xapian::Brass::open(path, Xapian::DB_CREATE_OR_OVERWRITE |
+				   Xapian::DB_PERMUTERM);
+    db.commit();
+    rodb = Xapian::Brass::open(path);
+    TEST_EQUAL(count_matches(rodb, "*ing"), 0);
+    db.add_document(doc);
+    db.commit();
+    rodb.reopen();
+    TEST_EQUAL(count_matches(rodb, "*ing"), 1);
+
+    return true;
+}
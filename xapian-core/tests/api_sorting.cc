@@ -150,6 +150,49 @@ DEFINE_TESTCASE(sortfunctor2,writable && !remote) {
     return true;
 }
 
+/// Test sorting by values which only differ after the first 8 bytes.
+DEFINE_TESTCASE(sortvalueprefix1,writable) {
+    Xapian::WritableDatabase db = get_writable_database();
+    Xapian::Document doc;
+    doc.add_term("foo");
+    doc.add_value(0, "2013-03-08 12:00");
+    db.add_document(doc);
+    doc.add_value(0, "2013-03-08");
+    db.add_document(doc);
+    doc.add_value(0, string("2013-03-", 9));
+    db.add_document(doc);
+    doc.add_value(0, "2013-03-08 09:30");
+    db.add_document(doc);
+    doc.add_value(0, "2013-03-");
+    db.add_document(doc);
+    doc.add_value(0, "2013-03-08\xff");
+    db.add_document(doc);
+    doc.add_value(0, "2013");
+    db.add_document(doc);
+    db.commit();
+
+    Xapian::Enquire enquire(db);
+    enquire.set_query(Xapian::Query("foo"));
+
+    enquire.set_sort_by_value(0, false);
+    Xapian::MSet mset = enquire.get_mset(0, 10);
+    mset_expect_order(mset, 7, 5, 3, 2, 4, 1, 6);
+
+    enquire.set_sort_by_value(0, true);
+    mset = enquire.get_mset(0, 10);
+    mset_expect_order(mset, 6, 1, 4, 2, 3, 5, 7);
+
+    // Check the proto-MSet handles these correctly when it is full.
+    mset = enquire.get_mset(0, 3);
+    mset_expect_order(mset, 6, 1, 4);
+
+    enquire.set_sort_by_value_then_relevance(0, false);
+    mset = enquire.get_mset(0, 3);
+    mset_expect_order(mset, 7, 5, 3);
+
+    return true;
+}
+
 class NeverUseMeKeyMaker : public Xapian::KeyMaker {
   public:
     std::string operator() (const Xapian::Document &) const
@@ -126,3 +126,33 @@ DEFINE_TESTCASE(canceltransaction2, transactions) {
 
     return true;
 }
+
+/// Test document lengths read during a cancelled transaction don't persist.
+DEFINE_TESTCASE(canceltransaction3, transactions) {
+    Xapian::WritableDatabase db(get_writable_database("apitest_simpledata"));
+
+    Xapian::doccount docs = db.get_doccount();
+    Xapian::termcount len1 = db.get_doclength(1);
+    db.begin_transaction();
+    db.delete_document(1);
+    Xapian::Document doc;
+    doc.add_term("befuddlement", 3);
+    Xapian::docid did = db.add_document(doc);
+    // With a gap in the docids, iterating all documents flushes the pending
+    // document lengths to the table, so the lookups below read them from
+    // there.
+    Xapian::doccount count = 0;
+    Xapian::PostingIterator p;
+    for (p = db.postlist_begin(string()); p != db.postlist_end(string()); ++p)
+	++count;
+    TEST_EQUAL(count, docs);
+    TEST_EQUAL(db.get_doclength(did), 3);
+    TEST_EXCEPTION(Xapian::DocNotFoundError, db.get_doclength(1));
+    db.cancel_transaction();
+
+    TEST_EQUAL(db.get_doccount(), docs);
+    TEST_EXCEPTION(Xapian::DocNotFoundError, db.get_doclength(did));
+    TEST_EQUAL(db.get_doclength(1), len1);
+
+    return true;
+}
@@ -1687,6 +1687,60 @@ DEFINE_TESTCASE(synonymitor1, writable && synonyms) {
     return true;
 }
 
+static string
+get_synonyms(const Xapian::Database & db, const string & term)
+{
+    string s = "|";
+    Xapian::TermIterator t;
+    for (t = db.synonyms_begin(term); t != db.synonyms_end(term); ++t) {
+	s += *t;
+	s += '|';
+    }
+    return s;
+}
+
+/// Check looking up synonyms doesn't hide later changes.
+DEFINE_TESTCASE(synonymitor2, writable && synonyms) {
+    Xapian::WritableDatabase db = get_writable_database();
+    db.add_synonym("hello", "hi");
+    db.commit();
+
+    Xapian::Database db_r = get_writable_database_as_database();
+    TEST_STRINGS_EQUAL(get_synonyms(db_r, "hello"), "|hi|");
+    TEST_STRINGS_EQUAL(get_synonyms(db_r, "goodbye"), "|");
+
+    // Look up terms, then change their synonyms.
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|hi|");
+    db.add_synonym("goodbye", "bye");
+    db.add_synonym("hello", "howdy");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|bye|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|hi|howdy|");
+    db.remove_synonym("hello", "hi");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|bye|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|howdy|");
+    db.commit();
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|bye|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|howdy|");
+
+    // Changes which are cancelled shouldn't be seen afterwards.
+    db.begin_transaction();
+    db.clear_synonyms("goodbye");
+    db.add_synonym("hello", "hiya");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|hiya|howdy|");
+    db.cancel_transaction();
+    TEST_STRINGS_EQUAL(get_synonyms(db, "goodbye"), "|bye|");
+    TEST_STRINGS_EQUAL(get_synonyms(db, "hello"), "|howdy|");
+
+    // The reader should see the new synonyms once it's reopened.
+    db_r.reopen();
+    TEST_STRINGS_EQUAL(get_synonyms(db_r, "hello"), "|howdy|");
+    TEST_STRINGS_EQUAL(get_synonyms(db_r, "goodbye"), "|bye|");
+
+    return true;
+}
+
 // Test that adding a document with a really long term gives an error on
 // add_document() rather than on commit().
 DEFINE_TESTCASE(termtoolong1, writable) {
@@ -1788,6 +1842,118 @@ DEFINE_TESTCASE(postlist7, writable) {
     return true;
 }
 
+/// Check a new term's postlist spanning several chunks is written correctly.
+DEFINE_TESTCASE(newtermchunks1, writable) {
+    Xapian::WritableDatabase db = get_writable_database();
+
+    // Enough postings that brass needs several chunks for "common", all in
+    // one flush so that the term is new when the changes are merged.  Also
+    // delete some documents before the flush, so the postlist being written
+    // has deleted entries to skip.
+    const Xapian::docid N = 5000;
+    Xapian::termcount collfreq = 0;
+    for (Xapian::docid did = 1; did <= N; ++did) {
+	Xapian::Document doc;
+	doc.add_term("common", did % 5 + 1);
+	db.add_document(doc);
+    }
+    for (Xapian::docid did = 1; did <= N; did += 97) {
+	db.delete_document(did);
+    }
+    db.commit();
+
+    Xapian::doccount termfreq = 0;
+    for (Xapian::docid did = 1; did <= N; ++did) {
+	if (did % 97 == 1) continue;
+	++termfreq;
+	collfreq += did % 5 + 1;
+    }
+    TEST_EQUAL(db.get_termfreq("common"), termfreq);
+    TEST_EQUAL(db.get_collection_freq("common"), collfreq);
+
+    Xapian::PostingIterator p = db.postlist_begin("common");
+    for (Xapian::docid did = 1; did <= N; ++did) {
+	if (did % 97 == 1) continue;
+	TEST(p != db.postlist_end("common"));
+	TEST_EQUAL(*p, did);
+	TEST_EQUAL(p.get_wdf(), did % 5 + 1);
+	++p;
+    }
+    TEST(p == db.postlist_end("common"));
+
+    // Check skip_to() can find entries in later chunks.
+    p = db.postlist_begin("common");
+    p.skip_to(N - 10);
+    TEST(p != db.postlist_end("common"));
+    TEST_EQUAL(*p, N - 10);
+
+    // Now the term exists, further changes are merged into its chunks.
+    Xapian::Document doc;
+    doc.add_term("common", 7);
+    Xapian::docid did = db.add_document(doc);
+    db.commit();
+    TEST_EQUAL(db.get_termfreq("common"), termfreq + 1);
+    TEST_EQUAL(db.get_collection_freq("common"), collfreq + 7);
+    p = db.postlist_begin("common");
+    p.skip_to(did);
+    TEST(p != db.postlist_end("common"));
+    TEST_EQUAL(*p, did);
+    TEST_EQUAL(p.get_wdf(), 7);
+
+    return true;
+}
+
+/// Check term statistics are updated for a reader after a commit.
+DEFINE_TESTCASE(termstats1, writable) {
+    // Inmemory doesn't support get_writable_database_as_database().
+    SKIP_TEST_FOR_BACKEND("inmemory");
+
+    Xapian::WritableDatabase db_w = get_writable_database();
+    // Enough postings that the first chunk of "big" won't fit in one item.
+    for (Xapian::termcount i = 0; i != 2000; ++i) {
+	Xapian::Document doc;
+	doc.add_term("big", i % 7 + 1);
+	if (i % 100 == 0) doc.add_term("small");
+	db_w.add_document(doc);
+    }
+    db_w.commit();
+
+    Xapian::Database db = get_writable_database_as_database();
+    for (int pass = 0; pass != 2; ++pass) {
+	TEST_EQUAL(db.get_termfreq("big"), 2000);
+	TEST_EQUAL(db.get_collection_freq("big"), 7995);
+	TEST_REL(db.get_wdf_upper_bound("big"),>=,7);
+	TEST_EQUAL(db.get_termfreq("small"), 20);
+	TEST_EQUAL(db.get_collection_freq("small"), 20);
+	TEST_EQUAL(db.get_termfreq("missing"), 0);
+	TEST_EQUAL(db.get_collection_freq("missing"), 0);
+    }
+
+    for (Xapian::docid did = 1; did <= 2000; did += 100) {
+	db_w.delete_document(did);
+    }
+    Xapian::Document doc;
+    doc.add_term("missing", 2);
+    db_w.add_document(doc);
+    TEST_EQUAL(db_w.get_termfreq("big"), 1980);
+    TEST_EQUAL(db_w.get_termfreq("small"), 0);
+    TEST_EQUAL(db_w.get_termfreq("missing"), 1);
+    db_w.commit();
+
+    // Until it's reopened, the reader should see the old revision.
+    TEST_EQUAL(db.get_termfreq("big"), 2000);
+    db.reopen();
+    TEST_EQUAL(db.get_termfreq("big"), 1980);
+    TEST_EQUAL(db.get_termfreq("small"), 0);
+    TEST_EQUAL(db.get_collection_freq("small"), 0);
+    TEST_EQUAL(db.get_termfreq("missing"), 1);
+    TEST_EQUAL(db.get_collection_freq("missing"), 2);
+    TEST_EQUAL(db_w.get_termfreq("big"), 1980);
+    TEST_EQUAL(db_w.get_collection_freq("missing"), 2);
+
+    return true;
+}
+
 DEFINE_TESTCASE(lazytablebug1, brass || chert) {
     {
 	Xapian::WritableDatabase db = get_named_writable_database("lazytablebug1", string());
@@ -826,12 +826,32 @@ static bool test_tg_max_word_length1()
     return true;
 }
 
+static bool test_tg_edge_ngram1()
+{
+    Xapian::TermGenerator termgen;
+    termgen.set_stemmer(Xapian::Stem("en"));
+    termgen.set_max_edge_ngram_length(3);
+
+    Xapian::Document doc;
+    termgen.set_document(doc);
+
+    termgen.index_text("an ox");
+    termgen.index_text("cafés", 1, "XT");
+
+    TEST_STRINGS_EQUAL(format_doc_termlist(doc),
+		       "XTcafés[3] ZXTcafé:1 Zan:1 Zox:1 an[1] ox[2] "
+		       "~XTc:1 ~XTca:1 ~XTcaf:1 ~a:1 ~an:1 ~o:1 ~ox:1");
+
+    return true;
+}
+
 /// Test cases for the TermGenerator.
 static const test_desc tests[] = {
     TESTCASE(termgen1),
     TESTCASE(tg_spell1),
     TESTCASE(tg_spell2),
     TESTCASE(tg_max_word_length1),
+    TESTCASE(tg_edge_ngram1),
     END_OF_TESTCASES
 };
 
@@ -27,11 +27,17 @@
 
 #include "omassert.h"
 #include "api/omenquireinternal.h"
+#include "api/queryinternal.h"
 #include "str.h"
+#include "stringutils.h"
 #include "api/termlist.h"
+#include "backends/wildcardtermlist.h"
 
 #include "autoptr.h"
+#include <algorithm>
 #include <set>
+#include <typeinfo>
+#include <vector>
 
 using namespace std;
 
@@ -62,6 +68,67 @@ Weight::Internal::operator +=(const Weight::Internal & inc)
     return *this;
 }
 
+void
+Weight::Internal::mark_wanted_terms(const Xapian::Query &query)
+{
+    if (query.empty()) return;
+
+    query.internal->gather_wildcards(static_cast<void*>(&wildcards));
+    // The same subquery can appear more than once in the query tree.
+    sort(wildcards.begin(), wildcards.end());
+    wildcards.erase(unique(wildcards.begin(), wildcards.end()),
+		    wildcards.end());
+    // Forget the terms the wildcards expanded to in any previous match, as
+    // we don't want to count them as ordinary query terms.
+    vector<const Xapian::Internal::QueryWildcard *>::const_iterator w;
+    for (w = wildcards.begin(); w != wildcards.end(); ++w) {
+	vector<string> none;
+	(*w)->set_expanded_terms(none);
+    }
+
+    Xapian::TermIterator t;
+    for (t = query.get_terms_begin(); t != Xapian::TermIterator(); ++t) {
+	if (termfreqs.insert(make_pair(*t, TermFreqs())).second)
+	    query_terms.push_back(*t);
+    }
+}
+
+const vector<string> *
+Weight::Internal::get_wildcard_expansion(const Xapian::Database::Internal * subdb,
+					 const Xapian::Internal::QueryWildcard * wildcard) const
+{
+    map<pair<const Xapian::Database::Internal *,
+	     const Xapian::Internal::QueryWildcard *>,
+	vector<string> >::const_iterator i;
+    i = wildcard_expansions.find(make_pair(subdb, wildcard));
+    if (i == wildcard_expansions.end()) return NULL;
+    return &i->second;
+}
+
+void
+Weight::Internal::record_wildcard_terms() const
+{
+    vector<const Xapian::Internal::QueryWildcard *>::const_iterator w;
+    for (w = wildcards.begin(); w != wildcards.end(); ++w) {
+	const string & pattern = (*w)->get_pattern();
+	vector<string> terms;
+	map<string, TermFreqs>::const_iterator t;
+	if (pattern.find('*') == string::npos) {
+	    // The terms with this prefix are together in the map.
+	    for (t = termfreqs.lower_bound(pattern);
+		 t != termfreqs.end() && startswith(t->first, pattern); ++t) {
+		if (t->second.termfreq) terms.push_back(t->first);
+	    }
+	} else {
+	    for (t = termfreqs.begin(); t != termfreqs.end(); ++t) {
+		if (t->second.termfreq && wildcard_matches(pattern, t->first))
+		    terms.push_back(t->first);
+	    }
+	}
+	(*w)->set_expanded_terms(terms);
+    }
+}
+
 Xapian::doccount
 Weight::Internal::get_termfreq(const string & term) const
 {
@@ -81,12 +148,34 @@ Weight::Internal::accumulate_stats(const Xapian::Database::Internal &subdb,
     collection_size += subdb.get_doccount();
     rset_size += rset.size();
 
-    map<string, TermFreqs>::iterator t;
-    for (t = termfreqs.begin(); t != termfreqs.end(); ++t) {
-	const string & term = t->first;
-	t->second.termfreq += subdb.get_termfreq(term);
+    // The terms a wildcard expands to differ between sub-databases, so we
+    // add an entry for each term it expands to in this one.  A term can be
+    // matched by several wildcards and be in the query too, but must only be
+    // counted once for each sub-database.
+    set<string> expanded;
+    vector<pair<string, Xapian::doccount> > terms;
+    vector<const Xapian::Internal::QueryWildcard *>::const_iterator w;
+    for (w = wildcards.begin(); w != wildcards.end(); ++w) {
+	(*w)->expand_terms(subdb, terms);
+	vector<string> & expansion =
+	    wildcard_expansions[make_pair(&subdb, *w)];
+	expansion.reserve(terms.size());
+	vector<pair<string, Xapian::doccount> >::const_iterator i;
+	for (i = terms.begin(); i != terms.end(); ++i) {
+	    expansion.push_back(i->first);
+	    if (expanded.insert(i->first).second)
+		termfreqs[i->first].termfreq += i->second;
+	}
+    }
+
+    vector<string>::const_iterator q;
+    for (q = query_terms.begin(); q != query_terms.end(); ++q) {
+	if (expanded.find(*q) != expanded.end())
+	    continue;
+	termfreqs[*q].termfreq += subdb.get_termfreq(*q);
     }
 
+    map<string, TermFreqs>::iterator t;
     const set<Xapian::docid> & items(rset.internal->get_items());
     set<Xapian::docid>::const_iterator d;
     for (d = items.begin(); d != items.end(); ++d) {
@@ -120,6 +209,35 @@ Weight::Internal::get_reltermfreq(const string & term) const
     return tfreq->second.reltermfreq;
 }
 
+void
+Weight::Internal::init_inline_sumpart(const Xapian::Weight & wt,
+				      InlineSumPart & out)
+{
+    // Only handle the exact classes - a subclass could override get_sumpart().
+    const type_info & type = typeid(wt);
+    if (type == typeid(Xapian::BM25Weight)) {
+	const Xapian::BM25Weight & bm25 =
+	    static_cast<const Xapian::BM25Weight &>(wt);
+	out.type = InlineSumPart::BM25;
+	out.factor = bm25.termweight * (bm25.param_k1 + 1);
+	out.len_factor = bm25.len_factor;
+	out.k1 = bm25.param_k1;
+	out.b = bm25.param_b;
+	out.one_minus_b = 1 - bm25.param_b;
+	out.min_normlen = bm25.param_min_normlen;
+    } else if (type == typeid(Xapian::TradWeight)) {
+	const Xapian::TradWeight & trad =
+	    static_cast<const Xapian::TradWeight &>(wt);
+	out.type = InlineSumPart::TRAD;
+	out.factor = trad.termweight;
+	out.len_factor = trad.len_factor;
+    } else if (type == typeid(Xapian::BoolWeight)) {
+	out.type = InlineSumPart::ZERO;
+    } else {
+	out.type = InlineSumPart::NONE;
+    }
+}
+
 string
 Weight::Internal::get_description() const
 {
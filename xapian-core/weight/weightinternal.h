@@ -30,8 +30,11 @@
 #include "backends/database.h"
 #include "internaltypes.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 /// A pair holding a termfreq and reltermfreq.
 struct TermFreqs {
@@ -51,10 +54,54 @@ struct TermFreqs {
     std::string get_description() const;
 };
 
+/** Calculates get_sumpart() for the built-in weighting schemes inline.
+ *
+ *  LeafPostList::get_weight() is called for every posting considered, so
+ *  for BM25Weight, TradWeight and BoolWeight we avoid the virtual method call
+ *  by evaluating the same formula here.  The operations are performed in the
+ *  same order as the get_sumpart() implementations, so the weights returned
+ *  are identical.
+ */
+struct InlineSumPart {
+    /// Which formula to use (NONE means call Weight::get_sumpart()).
+    enum { NONE, ZERO, BM25, TRAD } type;
+
+    /// The document independent factor (including (k1 + 1) for BM25).
+    double factor;
+
+    /// Factor to multiply the document length by.
+    Xapian::doclength len_factor;
+
+    /// BM25 parameters, with (1 - b) precalculated.
+    double k1, b, one_minus_b;
+
+    /// BM25 minimum normalised document length.
+    Xapian::doclength min_normlen;
+
+    InlineSumPart() : type(NONE) { }
+
+    double get_sumpart(Xapian::termcount wdf, Xapian::termcount len) const {
+	double wdf_double(wdf);
+	if (type == BM25) {
+	    Xapian::doclength normlen = std::max(len * len_factor, min_normlen);
+	    double denom = k1 * (normlen * b + one_minus_b) + wdf_double;
+	    return factor * (wdf_double / denom);
+	}
+	if (type == TRAD) {
+	    return factor * (wdf_double / (len * len_factor + wdf_double));
+	}
+	return 0;
+    }
+};
+
 namespace Xapian {
 
 class RSet;
 
+namespace Internal {
+class QueryWildcard;
+}
+
 /** Class to hold statistics for a given collection. */
 class Weight::Internal {
   public:
@@ -74,6 +121,21 @@ class Weight::Internal {
      *  collection. */
     std::map<std::string, TermFreqs> termfreqs;
 
+    /// The terms in the query, other than those from OP_WILDCARD.
+    std::vector<std::string> query_terms;
+
+    /// The OP_WILDCARD subqueries in the query.
+    std::vector<const Xapian::Internal::QueryWildcard *> wildcards;
+
+    /** The terms each wildcard expanded to in each sub-database.
+     *
+     *  These are kept so the matcher doesn't need to expand the wildcards
+     *  again when it builds the postlist tree.
+     */
+    std::map<std::pair<const Xapian::Database::Internal *,
+		       const Xapian::Internal::QueryWildcard *>,
+	     std::vector<std::string> > wildcard_expansions;
+
     Internal() : total_length(0), collection_size(0), rset_size(0) { }
 
     /** Add in the supplied statistics from a sub-database.
@@ -83,13 +145,23 @@ class Weight::Internal {
      */
     Internal & operator +=(const Internal & inc);
 
-    /// Mark the terms we need to collate stats for.
-    void mark_wanted_terms(const Xapian::Query &query) {
-	Xapian::TermIterator t;
-	for (t = query.get_terms_begin(); t != Xapian::TermIterator(); ++t) {
-	    termfreqs.insert(make_pair(*t, TermFreqs()));
-	}
-    }
+    /// Mark the terms (and wildcards) we need to collate stats for.
+    void mark_wanted_terms(const Xapian::Query &query);
+
+    /** Return the terms @a wildcard expanded to in @a subdb.
+     *
+     *  Returns NULL if we didn't accumulate the stats for @a subdb.
+     */
+    const std::vector<std::string> *
+    get_wildcard_expansion(const Xapian::Database::Internal * subdb,
+			   const Xapian::Internal::QueryWildcard * wildcard) const;
+
+    /** Record in each OP_WILDCARD subquery the terms it expanded to.
+     *
+     *  These are the terms we collated stats for which match its pattern,
+     *  so this must be called after the stats have been accumulated.
+     */
+    void record_wildcard_terms() const;
 
     /// Accumulate the rtermfreqs for terms marked by mark_wanted_terms().
     void accumulate_stats(const Xapian::Database::Internal &sub_db,
@@ -117,6 +189,15 @@ class Weight::Internal {
     /** Set the "bounds" stats from Database @a db. */
     void set_bounds_from_db(const Xapian::Database &db_) { db = db_; }
 
+    /** Set up @a out to calculate @a wt's get_sumpart() inline.
+     *
+     *  If @a wt isn't exactly one of the built-in weighting schemes we know
+     *  how to handle, @a out is left with type NONE.  This must be called
+     *  after @a wt has been initialised.
+     */
+    static void init_inline_sumpart(const Xapian::Weight & wt,
+				    InlineSumPart & out);
+
     /// Return a std::string describing this object.
     std::string get_description() const;
 };